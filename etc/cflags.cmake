@@ -6,3 +6,31 @@ set(SANITIZING_FLAGS -fno-sanitize-recover=all -fsanitize=undefined -fsanitize=a
 # ask for more warnings from the compiler
 set (CMAKE_BASE_CXX_FLAGS "${CMAKE_CXX_FLAGS}")
 set (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wpedantic -Wextra -Weffc++ -Werror -Wshadow -Wpointer-arith -Wcast-qual -Wformat=2 -Wno-unqualified-std-cast-call")
+
+# select the Reassembler's storage backend (see src/reassembler.hh)
+option (MINNOW_BITMAP_REASSEMBLER "Store out-of-order Reassembler bytes in a packed bitmap" OFF)
+if (MINNOW_BITMAP_REASSEMBLER)
+  add_compile_definitions (MINNOW_BITMAP_REASSEMBLER)
+endif ()
+
+# build the bitmap backend's AVX2 scan (see src/bitmap_store.cc) and run the Reassembler tests against it;
+# on by default when the compiler takes -mavx2 and this machine can run the result
+include (CheckCXXCompilerFlag)
+include (CheckCXXSourceRuns)
+check_cxx_compiler_flag (-mavx2 MINNOW_COMPILER_HAS_AVX2)
+if (MINNOW_COMPILER_HAS_AVX2)
+  set (CMAKE_REQUIRED_FLAGS -mavx2)
+  check_cxx_source_runs ("int main() { return __builtin_cpu_supports( \"avx2\" ) ? 0 : 1; }" MINNOW_CPU_HAS_AVX2)
+  unset (CMAKE_REQUIRED_FLAGS)
+endif ()
+option (MINNOW_AVX2 "Build the bitmap Reassembler's AVX2 path with -mavx2 and test it" ${MINNOW_CPU_HAS_AVX2})
+if (MINNOW_AVX2 AND NOT MINNOW_COMPILER_HAS_AVX2)
+  message (FATAL_ERROR "MINNOW_AVX2 is on, but the compiler does not accept -mavx2")
+endif ()
+
+# compile in the event trace for the listed modules (see util/trace.hh), e.g. -DMINNOW_TRACE="sender;receiver"
+set (MINNOW_TRACE "" CACHE STRING "Modules whose events are recorded by MINNOW_TRACE (sender, receiver)")
+foreach (trace_module ${MINNOW_TRACE})
+  string (TOUPPER ${trace_module} trace_module)
+  add_compile_definitions (MINNOW_TRACE_${trace_module})
+endforeach (trace_module)
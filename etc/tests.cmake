@@ -31,6 +31,16 @@ ttest(reassembler_dup)
 ttest(reassembler_holes)
 ttest(reassembler_overlapping)
 ttest(reassembler_win)
+ttest(reassembler_stats)
+
+set(MINNOW_REASSEMBLER_TESTS reassembler_single reassembler_cap reassembler_seq reassembler_dup reassembler_holes
+  reassembler_overlapping reassembler_win reassembler_stats)
+if (MINNOW_AVX2)
+  foreach(test_name ${MINNOW_REASSEMBLER_TESTS})
+    add_test(NAME ${test_name}_bitmap_avx2 COMMAND "${test_name}_bitmap_avx2")
+    set_property(TEST ${test_name}_bitmap_avx2 PROPERTY FIXTURES_REQUIRED compile)
+  endforeach()
+endif()
 
 ttest(wrapping_integers_cmp)
 ttest(wrapping_integers_wrap)
@@ -45,19 +55,32 @@ ttest(recv_reorder)
 ttest(recv_reorder_more)
 ttest(recv_close)
 ttest(recv_special)
+ttest(recv_sack)
+ttest(recv_delayed_ack)
+ttest(recv_autotune)
 
 ttest(send_connect)
 ttest(send_transmit)
 ttest(send_retx)
+ttest(send_fast_retx)
+ttest(send_sack)
 ttest(send_window)
 ttest(send_ack)
 ttest(send_close)
 ttest(send_extra)
+ttest(send_segmentation)
+ttest(send_mss)
+ttest(send_congestion)
+ttest(send_rto)
+ttest(congestion_control)
+ttest(congestion_cubic)
 
 ttest(net_interface)
 
 ttest(router)
 
+ttest(trace_dump)
+
 add_custom_target (check0 COMMAND ${CMAKE_CTEST_COMMAND} --output-on-failure --stop-on-failure --timeout 12 -R 'webget|^byte_stream_')
 
 add_custom_target (check_webget COMMAND ${CMAKE_CTEST_COMMAND} --output-on-failure --timeout 12 -R 'webget')
@@ -89,4 +112,8 @@ set_property(TEST ${compile_name_opt} PROPERTY TIMEOUT -1)
 set_tests_properties(${compile_name_opt} PROPERTIES FIXTURES_SETUP compile_opt)
 
 stest(byte_stream_speed_test)
+stest(byte_stream_spsc_speed_test)
 stest(reassembler_speed_test)
+stest(reassembler_bitmap_speed_test)
+stest(sender_speed_test)
+stest(sender_segments_speed_test)
@@ -0,0 +1,208 @@
+#include "bitmap_store.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+constexpr uint64_t word_bits = 64;
+constexpr uint64_t all_ones = ~uint64_t{0};
+
+// bits [lo, hi) of a word, with 0 <= lo < hi <= 64
+uint64_t word_mask(uint64_t lo, uint64_t hi)
+{
+  return (all_ones >> (word_bits - (hi - lo))) << lo;
+}
+} // namespace
+
+void BitmapStore::insert(uint64_t base, uint64_t first_index, string data)
+{
+  const uint64_t len = data.size();
+  if (len == 0) return;
+  if (first_index + len - base > _bytes.size()) {
+    _grow(base, first_index + len - base);
+  }
+
+  // 环形缓冲：先写到末端，剩余部分回绕到开头
+  const uint64_t pos = first_index & (_bytes.size() - 1);
+  const uint64_t first = min(len, _bytes.size() - pos);
+  memcpy(_bytes.data() + pos, data.data(), first);
+  memcpy(_bytes.data(), data.data() + first, len - first);
+  _pending_bytes += _set_bits(pos, pos + first);
+  _pending_bytes += _set_bits(0, len - first);
+}
+
+string BitmapStore::pop(uint64_t base)
+{
+  if (_pending_bytes == 0) return {};
+  const uint64_t size = _bytes.size();
+  const uint64_t pos = base & (size - 1);
+
+  // 从pos开始的连续段，到末端后可能回绕到开头
+  uint64_t first = _run_end(pos, size) - pos;
+  uint64_t second = 0;
+  if (pos + first == size) {
+    second = _run_end(0, pos);
+  }
+  if (first == 0) return {};
+
+  string ready(first + second, '\0');
+  memcpy(ready.data(), _bytes.data() + pos, first);
+  memcpy(ready.data() + first, _bytes.data(), second);
+  _pending_bytes -= ready.size();
+  if (_pending_bytes == 0) {
+    // 所有空洞都已填满，归还整个环形缓冲
+    _bytes = string();
+    _bits = vector<uint64_t>();
+  } else {
+    _clear_bits(pos, pos + first);
+    _clear_bits(0, second);
+  }
+  return ready;
+}
+
+uint64_t BitmapStore::segment_count(uint64_t base) const
+{
+  if (_pending_bytes == 0) return 0;
+  if (_pending_bytes == _bytes.size()) return 1;
+
+  // 数环上每段的起点：本位为1且前一位为0
+  uint64_t starts = 0;
+  uint64_t carry = _bits.back() >> (word_bits - 1);
+  for (const uint64_t word : _bits) {
+    starts += popcount(word & ~((word << 1) | carry));
+    carry = word >> (word_bits - 1);
+  }
+  // 环上跨过窗口起点的一段，在字节流里其实是两段
+  const uint64_t mask = _bytes.size() - 1;
+  if (_test(base & mask) && _test((base - 1) & mask)) {
+    starts++;
+  }
+  return starts;
+}
+
+vector<pair<uint64_t, uint64_t>> BitmapStore::ranges(uint64_t base, size_t max_count) const
+{
+  vector<pair<uint64_t, uint64_t>> result;
+  if (_pending_bytes == 0) return result;
+  const uint64_t size = _bytes.size();
+  const uint64_t pos = base & (size - 1);
+
+  // 环上[lo, hi)里的每段换算成流下标，lo对应index_of_lo
+  const auto scan = [&](uint64_t lo, uint64_t hi, uint64_t index_of_lo) {
+    uint64_t at = lo;
+    while (result.size() <= max_count) {
+      const uint64_t start = _run_start(at, hi);
+      if (start == hi) return;
+      at = _run_end(start, hi);
+      const uint64_t first = index_of_lo + (start - lo);
+      const uint64_t last = index_of_lo + (at - lo);
+      if (!result.empty() && result.back().second == first) {
+        // 跨过环末端的一段
+        result.back().second = last;
+      } else {
+        result.emplace_back(first, last);
+      }
+    }
+  };
+  scan(pos, size, base);
+  scan(0, pos, base + size - pos);
+  if (result.size() > max_count) {
+    result.resize(max_count);
+  }
+  return result;
+}
+
+void BitmapStore::_grow(uint64_t base, uint64_t span)
+{
+  const uint64_t old_size = _bytes.size();
+  const uint64_t new_size = bit_ceil(max(span, word_bits));
+  string bytes(new_size, '\0');
+  vector<uint64_t> bits(new_size / word_bits, 0);
+
+  // 把旧窗口[base, base + old_size)里已有的字节搬到新的位置
+  for (uint64_t index = base; index < base + old_size; index++) {
+    const uint64_t old_pos = index & (old_size - 1);
+    if (_test(old_pos)) {
+      const uint64_t new_pos = index & (new_size - 1);
+      bytes[new_pos] = _bytes[old_pos];
+      bits[new_pos / word_bits] |= uint64_t{1} << (new_pos % word_bits);
+    }
+  }
+  _bytes = std::move(bytes);
+  _bits = std::move(bits);
+}
+
+uint64_t BitmapStore::_set_bits(uint64_t from, uint64_t to)
+{
+  uint64_t newly_set = 0;
+  while (from < to) {
+    const uint64_t lo = from % word_bits;
+    const uint64_t hi = min(word_bits, lo + (to - from));
+    const uint64_t mask = word_mask(lo, hi);
+    uint64_t& word = _bits[from / word_bits];
+    newly_set += popcount(mask & ~word);
+    word |= mask;
+    from += hi - lo;
+  }
+  return newly_set;
+}
+
+void BitmapStore::_clear_bits(uint64_t from, uint64_t to)
+{
+  while (from < to) {
+    const uint64_t lo = from % word_bits;
+    const uint64_t hi = min(word_bits, lo + (to - from));
+    _bits[from / word_bits] &= ~word_mask(lo, hi);
+    from += hi - lo;
+  }
+}
+
+uint64_t BitmapStore::_run_end(uint64_t from, uint64_t limit) const
+{
+  // 先处理不对齐的第一个字
+  if (from < limit && from % word_bits != 0) {
+    const uint64_t missing = ~_bits[from / word_bits] >> (from % word_bits);
+    if (missing != 0) {
+      return min(limit, from + countr_zero(missing));
+    }
+    from += word_bits - from % word_bits;
+  }
+
+  uint64_t word = from / word_bits;
+  const uint64_t word_limit = (limit + word_bits - 1) / word_bits;
+#if defined(__AVX2__)
+  // 一次检查256位是否全为1
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  while (word + 4 <= word_limit) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_bits.data() + word));
+    if (!_mm256_testc_si256(block, ones)) break;
+    word += 4;
+  }
+#endif
+  while (word < word_limit && _bits[word] == all_ones) {
+    word++;
+  }
+  if (word == word_limit) {
+    return limit;
+  }
+  return min(limit, word * word_bits + countr_zero(~_bits[word]));
+}
+
+uint64_t BitmapStore::_run_start(uint64_t from, uint64_t limit) const
+{
+  while (from < limit) {
+    const uint64_t present = _bits[from / word_bits] >> (from % word_bits);
+    if (present != 0) {
+      return min(limit, from + countr_zero(present));
+    }
+    from += word_bits - from % word_bits;
+  }
+  return limit;
+}
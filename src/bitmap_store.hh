@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * BitmapStore: an alternative Reassembler storage, selected at compile time with
+ * MINNOW_BITMAP_REASSEMBLER. Bytes live in a power-of-two ring indexed by stream index,
+ * with one bit per byte in a packed uint64_t word array recording which bytes are present.
+ * Finding the ready prefix uses ctz (and AVX2 when the compiler targets it); the pending
+ * count is kept up to date with popcount as bits are set and cleared. The ring is allocated
+ * on the first out-of-order insert, grows to cover the window, and is freed once every hole
+ * has been filled.
+ */
+class BitmapStore
+{
+public:
+  // Store `data` at `first_index` (with `first_index` >= `base`, the first unassembled index)
+  void insert(uint64_t base, uint64_t first_index, std::string data);
+
+  // Remove and return the stored bytes that start exactly at `base` (empty if there are none)
+  std::string pop(uint64_t base);
+
+  bool empty() const { return _pending_bytes == 0; }
+  uint64_t bytes_pending() const { return _pending_bytes; }
+  uint64_t memory_usage() const { return _bytes.capacity() + _bits.capacity() * sizeof(uint64_t); }
+  uint64_t segment_count(uint64_t base) const; // separate runs of stored bytes (scans the bitmap)
+
+  // The first `max_count` runs of stored bytes, as [first, last) stream indices in increasing order
+  std::vector<std::pair<uint64_t, uint64_t>> ranges(uint64_t base, size_t max_count) const;
+
+private:
+  void _grow(uint64_t base, uint64_t span);
+  uint64_t _set_bits(uint64_t from, uint64_t to);        // returns how many bits were newly set
+  void _clear_bits(uint64_t from, uint64_t to);
+  bool _test(uint64_t pos) const { return (_bits[pos / 64] >> (pos % 64)) & 1; }
+  uint64_t _run_end(uint64_t from, uint64_t limit) const; // first clear bit in [from, limit), or limit
+  uint64_t _run_start(uint64_t from, uint64_t limit) const; // first set bit in [from, limit), or limit
+  std::string _bytes{};          // ring of stored bytes; size is a power of two
+  std::vector<uint64_t> _bits{}; // one bit per byte of _bytes
+  uint64_t _pending_bytes = 0;   // number of set bits
+};
@@ -1,12 +1,16 @@
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
-#include <iostream>
 
 #include "byte_stream.hh"
 
 using namespace std;
 
-ByteStream::ByteStream( uint64_t capacity ) : 
+ByteStream::ByteStream( uint64_t capacity, Storage storage ) : 
 capacity_( capacity ),
+storage_( storage ),
+head_(0),
+chunk_offset_(0),
 total_byte_in(0),
 total_byte_out(0),
 occupied_byte(0),
@@ -18,24 +22,27 @@ _has_error(false)
 void Writer::push( string data )
 {
   if (is_closed()) return;
-  auto ac = available_capacity();
-  auto dc = data.size();
-  if (ac <= 0) return;
-  if (ac >= dc) {
-    // 全写入
-    for (size_t i=0; i<dc; i++) {
-      this->buffer.push_back(data[i]);
-    }
-    occupied_byte += dc;
-    total_byte_in += dc;
-  } else {
-    // 部分写入
-    for (size_t i=0; i<ac; i++) {
-      this->buffer.push_back(data[i]);
-    }
-    occupied_byte = capacity_;
-    total_byte_in += ac;
+  const uint64_t len = min(static_cast<uint64_t>(data.size()), available_capacity());
+  if (len == 0) return;
+  if (storage_ == Storage::Chunked) {
+    // 直接接管调用者的字符串，超出容量的部分截掉
+    data.resize(len);
+    chunks_.push_back(std::move(data));
+    occupied_byte += len;
+    total_byte_in += len;
+    return;
+  }
+  if (buffer.size() != capacity_) {
+    // 延迟分配，只有真正写入时才占用内存
+    buffer.resize(capacity_);
   }
+  // 尾部到存储末端一段，剩余部分回绕到开头
+  const size_t tail = (head_ + occupied_byte) % capacity_;
+  const size_t first = min(len, capacity_ - tail);
+  memcpy(buffer.data() + tail, data.data(), first);
+  memcpy(buffer.data(), data.data() + first, len - first);
+  occupied_byte += len;
+  total_byte_in += len;
 }
 
 void Writer::close()
@@ -63,13 +70,68 @@ uint64_t Writer::bytes_pushed() const
   return total_byte_in;
 }
 
+uint64_t Writer::capacity() const
+{
+  return capacity_;
+}
+
+void Writer::set_capacity( uint64_t capacity )
+{
+  capacity = max(capacity, static_cast<uint64_t>(occupied_byte));
+  if (capacity == capacity_) return;
+  if (storage_ == Storage::Ring) {
+    if (occupied_byte == 0) {
+      // 空的时候直接释放，下次push再按新容量分配
+      string().swap(buffer);
+      head_ = 0;
+    } else {
+      // 把回绕的两段按顺序拷到新的存储开头
+      string resized(capacity, '\0');
+      size_t offset = 0;
+      for (const auto view : reader().peek_iovecs()) {
+        memcpy(resized.data() + offset, view.data(), view.size());
+        offset += view.size();
+      }
+      buffer = std::move(resized);
+      head_ = 0;
+    }
+  }
+  capacity_ = capacity;
+}
+
 string_view Reader::peek() const
 {
-  if (occupied_byte > 0) {
-    return string_view(buffer);
-  } else {
-    return {};
+  if (occupied_byte == 0) return {};
+  if (storage_ == Storage::Chunked) {
+    return string_view(chunks_.front()).substr(chunk_offset_);
   }
+  // 只返回连续的一段，回绕部分留给下一次peek
+  return {buffer.data() + head_, min(occupied_byte, capacity_ - head_)};
+}
+
+vector<string_view> Reader::peek_iovecs( uint64_t max_bytes ) const
+{
+  vector<string_view> views;
+  uint64_t remaining = min(max_bytes, static_cast<uint64_t>(occupied_byte));
+  if (remaining == 0) return views;
+  if (storage_ == Storage::Chunked) {
+    size_t offset = chunk_offset_;
+    for (const auto& chunk : chunks_) {
+      if (remaining == 0) break;
+      auto view = string_view(chunk).substr(offset, remaining);
+      views.push_back(view);
+      remaining -= view.size();
+      offset = 0;
+    }
+    return views;
+  }
+  // 环形缓冲最多分为两段：head_到末端，以及回绕到开头的部分
+  const size_t first = min(remaining, capacity_ - head_);
+  views.emplace_back(buffer.data() + head_, first);
+  if (remaining > first) {
+    views.emplace_back(buffer.data(), remaining - first);
+  }
+  return views;
 }
 
 bool Reader::is_finished() const
@@ -84,9 +146,22 @@ bool Reader::has_error() const
 
 void Reader::pop( uint64_t len )
 {
-  buffer = buffer.substr(len);
+  len = min(len, static_cast<uint64_t>(occupied_byte));
+  if (len == 0) return;
   occupied_byte -= len;
   total_byte_out += len;
+  if (storage_ == Storage::Chunked) {
+    // 整块丢弃已读完的chunk，不做拷贝
+    len += chunk_offset_;
+    while (len > 0 && len >= chunks_.front().size()) {
+      len -= chunks_.front().size();
+      chunks_.pop_front();
+    }
+    chunk_offset_ = len;
+    return;
+  }
+  // 清空时回到起点，让后续的peek尽量连续
+  head_ = occupied_byte == 0 ? 0 : (head_ + len) % capacity_;
 }
 
 uint64_t Reader::bytes_buffered() const
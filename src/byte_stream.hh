@@ -1,20 +1,40 @@
 #pragma once
 
+#include <deque>
 #include <queue>
 #include <stdexcept>
 #include <string>
 #include <array>
+#include <cstdint>
+#include <span>
 #include <string_view>
+#include <vector>
 
 class Reader;
 class Writer;
 
 class ByteStream
 {
+public:
+  /*
+   * How the stream keeps buffered bytes:
+   *   Ring:    one circular buffer of `capacity` bytes; every push is copied in.
+   *   Chunked: a queue of the strings handed to push(), moved in without copying.
+   */
+  enum class Storage
+  {
+    Ring,
+    Chunked
+  };
+
 protected:
   uint64_t capacity_;
   // Please add any additional state to the ByteStream here, and not to the Writer and Reader interfaces.
-  std::string buffer{};
+  Storage storage_;
+  std::string buffer{};              // circular storage, sized to capacity_ on the first push (Ring)
+  size_t head_;                      // index in `buffer` of the first buffered byte (Ring)
+  std::deque<std::string> chunks_{}; // pushed strings in stream order (Chunked)
+  size_t chunk_offset_;              // bytes already popped from chunks_.front() (Chunked)
   size_t total_byte_in;
   size_t total_byte_out;
   size_t occupied_byte;
@@ -22,7 +42,7 @@ protected:
   bool _has_error;
 
 public:
-  explicit ByteStream( uint64_t capacity );
+  explicit ByteStream( uint64_t capacity, Storage storage = Storage::Ring );
 
   // Helper functions (provided) to access the ByteStream's Reader and Writer interfaces
   Reader& reader();
@@ -42,12 +62,18 @@ public:
   bool is_closed() const;              // Has the stream been closed?
   uint64_t available_capacity() const; // How many bytes can be pushed to the stream right now?
   uint64_t bytes_pushed() const;       // Total number of bytes cumulatively pushed to the stream
+
+  uint64_t capacity() const; // Most bytes the stream will buffer at once
+  // Grow or shrink the capacity (never below bytes_buffered()); an empty ring gives its storage back
+  void set_capacity( uint64_t capacity );
 };
 
 class Reader : public ByteStream
 {
 public:
-  std::string_view peek() const; // Peek at the next bytes in the buffer
+  std::string_view peek() const; // Peek at the next contiguous bytes in the buffer
+  // Peek at up to `max_bytes` buffered bytes as every readable region, in order (e.g. for writev)
+  std::vector<std::string_view> peek_iovecs( uint64_t max_bytes = UINT64_MAX ) const;
   void pop( uint64_t len );      // Remove `len` bytes from the buffer
 
   bool is_finished() const; // Is the stream finished (closed and fully popped)?
@@ -62,3 +88,10 @@ public:
  * from a ByteStream Reader into a string;
  */
 void read( Reader& reader, uint64_t len, std::string& out );
+
+/*
+ * read_into: A helper function that pops up to `out.size()` bytes from a
+ * ByteStream Reader directly into `out` (at most two copies for the ring storage).
+ * Returns the number of bytes copied.
+ */
+uint64_t read_into( Reader& reader, std::span<char> out );
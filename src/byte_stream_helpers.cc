@@ -1,27 +1,39 @@
 #include "byte_stream.hh"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 
 /*
- * read: A helper function thats peeks and pops up to `len` bytes
- * from a ByteStream Reader into a string;
+ * read_into: A helper function that pops up to `out.size()` bytes from a
+ * ByteStream Reader into `out`, copying straight from the stream's storage.
+ * Returns the number of bytes copied.
  */
-void read( Reader& reader, uint64_t len, std::string& out )
+uint64_t read_into( Reader& reader, std::span<char> out )
 {
-  out.clear();
-
-  while ( reader.bytes_buffered() and out.size() < len ) {
-    auto view = reader.peek();
-
+  uint64_t copied = 0;
+  while ( reader.bytes_buffered() and copied < out.size() ) {
+    const auto view = reader.peek().substr( 0, out.size() - copied );
     if ( view.empty() ) {
       throw std::runtime_error( "Reader::peek() returned empty string_view" );
     }
-
-    view = view.substr( 0, len - out.size() ); // Don't return more bytes than desired.
-    out += view;
+    std::memcpy( out.data() + copied, view.data(), view.size() );
+    copied += view.size();
     reader.pop( view.size() );
   }
+  return copied;
+}
+
+/*
+ * read: A helper function thats peeks and pops up to `len` bytes
+ * from a ByteStream Reader into a string;
+ */
+void read( Reader& reader, uint64_t len, std::string& out )
+{
+  // Size the output once, then fill it in place.
+  out.resize( std::min( len, reader.bytes_buffered() ) );
+  out.resize( read_into( reader, out ) );
 }
 
 Reader& ByteStream::reader()
@@ -0,0 +1,204 @@
+#include "congestion_control.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+// RFC 5681 section 3.1: the initial window depends on the segment size
+uint64_t initial_window(uint64_t mss)
+{
+  if (mss > 2190) return 2 * mss;
+  if (mss > 1095) return 3 * mss;
+  return 4 * mss;
+}
+} // namespace
+
+CongestionControl::CongestionControl(uint64_t mss)
+  : mss_(max(mss, uint64_t{1}))
+  , cwnd_(initial_window(mss_))
+  , ssthresh_(numeric_limits<uint64_t>::max())
+{}
+
+void CongestionControl::set_mss(uint64_t mss, bool reset_window)
+{
+  mss_ = max(mss, uint64_t{1});
+  cwnd_ = reset_window ? initial_window(mss_) : max(cwnd_, mss_);
+}
+
+uint64_t CongestionControl::loss_ssthresh(uint64_t in_flight) const
+{
+  return max(in_flight / 2, 2 * mss_);
+}
+
+void CongestionControl::grow(uint64_t acked)
+{
+  if (in_slow_start()) {
+    // 慢启动：每个ack最多增加一个MSS
+    cwnd_ += min(acked, mss_);
+    return;
+  }
+  // 拥塞避免：每确认一个cwnd的数据增加一个MSS
+  bytes_acked_ += acked;
+  if (bytes_acked_ >= cwnd_) {
+    bytes_acked_ -= cwnd_;
+    cwnd_ += mss_;
+  }
+}
+
+void CongestionControl::on_fast_retransmit(uint64_t in_flight, uint64_t next_seqno)
+{
+  ssthresh_ = loss_ssthresh(in_flight);
+  // 三个重复ack代表已有三个报文离开网络
+  cwnd_ = ssthresh_ + 3 * mss_;
+  bytes_acked_ = 0;
+  in_recovery_ = true;
+  recover_ = next_seqno;
+}
+
+void CongestionControl::on_duplicate_ack()
+{
+  if (in_recovery_) cwnd_ += mss_;
+}
+
+void CongestionControl::on_timeout(uint64_t in_flight, uint64_t next_seqno, bool repeated)
+{
+  // 同一个报文再次超时时cwnd已经是1个MSS，不能据此再降ssthresh
+  if (!repeated) ssthresh_ = loss_ssthresh(in_flight);
+  // 超时后回到一个MSS重新慢启动
+  cwnd_ = mss_;
+  bytes_acked_ = 0;
+  in_recovery_ = false;
+  recover_ = next_seqno;
+}
+
+bool RenoCongestionControl::on_ack(uint64_t /* ackno */, uint64_t acked, uint64_t /* in_flight */)
+{
+  if (in_recovery_) {
+    // 任何新数据的ack都结束快速恢复
+    in_recovery_ = false;
+    cwnd_ = ssthresh_;
+    return false;
+  }
+  grow(acked);
+  return false;
+}
+
+bool NewRenoCongestionControl::on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight)
+{
+  if (!in_recovery_) {
+    grow(acked);
+    return false;
+  }
+  if (ackno >= recover_) {
+    // 完全ack：收缩窗口并结束快速恢复
+    in_recovery_ = false;
+    cwnd_ = min(ssthresh_, max(in_flight - acked, mss_) + mss_);
+    return false;
+  }
+  // 部分ack：按确认量收缩窗口，立即重传下一个缺口
+  cwnd_ -= min(acked, cwnd_ - mss_);
+  if (acked >= mss_) cwnd_ += mss_;
+  return true;
+}
+
+CubicCongestionControl::CubicCongestionControl(uint64_t mss, bool fast_convergence)
+  : NewRenoCongestionControl(mss)
+  , fast_convergence_(fast_convergence)
+{}
+
+uint64_t CubicCongestionControl::loss_ssthresh(uint64_t /* in_flight */) const
+{
+  return max(static_cast<uint64_t>(static_cast<double>(cwnd_) * BETA), 2 * mss_);
+}
+
+void CubicCongestionControl::on_loss()
+{
+  const double cwnd = static_cast<double>(cwnd_) / static_cast<double>(mss_);
+  if (fast_convergence_ && cwnd < w_max_) {
+    // 快速收敛：在上一个W_max之前就丢包，说明有新流加入，让出更多带宽
+    w_max_ = cwnd * (1 + BETA) / 2;
+  } else {
+    w_max_ = cwnd;
+  }
+  epoch_started_ = false;
+}
+
+void CubicCongestionControl::on_fast_retransmit(uint64_t in_flight, uint64_t next_seqno)
+{
+  on_loss();
+  NewRenoCongestionControl::on_fast_retransmit(in_flight, next_seqno);
+}
+
+void CubicCongestionControl::on_timeout(uint64_t in_flight, uint64_t next_seqno, bool repeated)
+{
+  if (!repeated) on_loss();
+  NewRenoCongestionControl::on_timeout(in_flight, next_seqno, repeated);
+}
+
+void CubicCongestionControl::start_epoch()
+{
+  const double cwnd = static_cast<double>(cwnd_) / static_cast<double>(mss_);
+  epoch_started_ = true;
+  epoch_start_ms_ = now_ms_;
+  growth_carry_ = 0;
+  w_est_ = cwnd;
+  if (cwnd < w_max_) {
+    k_ = cbrt((w_max_ - cwnd) / C);
+  } else {
+    // 还没有丢过包或已超过W_max：从当前窗口开始探测
+    k_ = 0;
+    w_max_ = cwnd;
+  }
+}
+
+bool CubicCongestionControl::on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight)
+{
+  if (in_recovery_ || in_slow_start()) {
+    return NewRenoCongestionControl::on_ack(ackno, acked, in_flight);
+  }
+  if (!epoch_started_) start_epoch();
+
+  const double mss = static_cast<double>(mss_);
+  const double cwnd = static_cast<double>(cwnd_) / mss;
+  const double segments_acked = static_cast<double>(acked) / mss;
+  const double t = static_cast<double>(now_ms_ - epoch_start_ms_) / 1000;
+
+  // 与Reno公平的窗口估计：每个RTT增加 3(1-β)/(1+β) 个报文
+  w_est_ += 3 * (1 - BETA) / (1 + BETA) * segments_acked / cwnd;
+
+  double target = C * pow(t - k_, 3) + w_max_;
+  target = min(max(target, cwnd), 1.5 * cwnd);
+
+  double growth = 0;
+  if (target < w_est_) {
+    // Reno友好区间
+    growth = (w_est_ - cwnd) * mss;
+  } else {
+    growth = (target - cwnd) / cwnd * segments_acked * mss;
+  }
+  growth_carry_ += growth;
+  const auto whole = static_cast<uint64_t>(growth_carry_);
+  cwnd_ += whole;
+  growth_carry_ -= static_cast<double>(whole);
+  return false;
+}
+
+unique_ptr<CongestionControl> make_congestion_control(CongestionControlAlgorithm algorithm,
+                                                      uint64_t mss,
+                                                      bool cubic_fast_convergence)
+{
+  switch (algorithm) {
+    case CongestionControlAlgorithm::Reno:
+      return make_unique<RenoCongestionControl>(mss);
+    case CongestionControlAlgorithm::NewReno:
+      return make_unique<NewRenoCongestionControl>(mss);
+    case CongestionControlAlgorithm::Cubic:
+      return make_unique<CubicCongestionControl>(mss, cubic_fast_convergence);
+    case CongestionControlAlgorithm::None:
+      break;
+  }
+  return nullptr;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "tcp_config.hh"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+/*
+ * CongestionControl: the policy that decides how many sequence numbers the TCPSender may
+ * have in flight, independent of the receiver's window. The sender keeps at most
+ * min(receiver window, cwnd()) outstanding and reports every event that matters to the
+ * policy: cumulative acks of new data, retransmission timeouts, and (once a loss has been
+ * inferred from duplicate acks) entry into and progress through fast recovery.
+ *
+ * All quantities are in sequence numbers; `mss` is the largest payload the sender puts in
+ * one segment. Subclasses implement the window-growth and loss-response rules.
+ */
+class CongestionControl
+{
+public:
+  explicit CongestionControl(uint64_t mss);
+  virtual ~CongestionControl() = default;
+
+  virtual std::string_view name() const = 0;
+
+  // `acked` new sequence numbers were cumulatively acknowledged, up to absolute seqno `ackno`;
+  // `in_flight` is how many were outstanding before the ack. Returns true if the oldest
+  // outstanding segment should be retransmitted right away (a partial ack during recovery).
+  virtual bool on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight) = 0;
+
+  // A loss was inferred from duplicate acks; `next_seqno` is the next absolute seqno to be sent.
+  virtual void on_fast_retransmit(uint64_t in_flight, uint64_t next_seqno);
+
+  // Another duplicate ack arrived while in fast recovery.
+  virtual void on_duplicate_ack();
+
+  // The retransmission timer expired. `repeated` if it expired again for the same segment (after
+  // back-off); ssthresh then keeps the value from the first timeout (RFC 5681, note on eq. 4).
+  virtual void on_timeout(uint64_t in_flight, uint64_t next_seqno, bool repeated);
+
+  // The sender's MSS changed. With `reset_window` (MSS negotiated before any data was sent) the
+  // initial window is recomputed; otherwise (path-MTU probing) the window keeps its size in
+  // sequence numbers, but is at least one segment.
+  void set_mss(uint64_t mss, bool reset_window);
+
+  // Time has passed (driven by TCPSender::tick); policies with time-based growth read now_ms_.
+  void on_tick(uint64_t ms_since_last_tick) { now_ms_ += ms_since_last_tick; }
+
+  uint64_t mss() const { return mss_; }
+  uint64_t cwnd() const { return cwnd_; }
+  uint64_t ssthresh() const { return ssthresh_; }
+  bool in_slow_start() const { return cwnd_ < ssthresh_; }
+  bool in_recovery() const { return in_recovery_; }
+
+protected:
+  virtual uint64_t loss_ssthresh(uint64_t in_flight) const; // max(FlightSize / 2, 2 * MSS)
+  void grow(uint64_t acked);                       // slow start or congestion avoidance
+
+  uint64_t mss_;
+  uint64_t cwnd_;
+  uint64_t ssthresh_;
+  uint64_t bytes_acked_ {0}; // acked seqnos not yet turned into window growth in congestion avoidance
+  bool in_recovery_ {false};
+  uint64_t recover_ {0};     // next seqno to be sent when recovery began
+  uint64_t now_ms_ {0};      // total time passed, in milliseconds
+};
+
+// RFC 5681: slow start, congestion avoidance, and fast recovery that ends on the first new ack.
+class RenoCongestionControl : public CongestionControl
+{
+public:
+  using CongestionControl::CongestionControl;
+  std::string_view name() const override { return "reno"; }
+  bool on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight) override;
+};
+
+// RFC 6582: like Reno, but a partial ack retransmits the next hole and stays in fast recovery.
+class NewRenoCongestionControl : public CongestionControl
+{
+public:
+  using CongestionControl::CongestionControl;
+  std::string_view name() const override { return "newreno"; }
+  bool on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight) override;
+};
+
+/*
+ * RFC 9438 CUBIC: after a loss the window follows W(t) = C * (t - K)^3 + W_max, where t is the
+ * time since the first ack after the loss and K is when the curve returns to W_max. Growth is
+ * fast far below W_max, flattens out around it, and then probes beyond it, independent of the
+ * RTT. The window never grows slower than the Reno-friendly estimate W_est, and fast recovery
+ * works as in NewReno. With fast convergence, a loss below the previous W_max releases
+ * bandwidth to newer flows by lowering W_max further.
+ */
+class CubicCongestionControl : public NewRenoCongestionControl
+{
+public:
+  static constexpr double C = 0.4;    // aggressiveness of the cubic curve, in segments / s^3
+  static constexpr double BETA = 0.7; // multiplicative decrease factor
+
+  explicit CubicCongestionControl(uint64_t mss, bool fast_convergence = true);
+  std::string_view name() const override { return "cubic"; }
+  bool on_ack(uint64_t ackno, uint64_t acked, uint64_t in_flight) override;
+  void on_fast_retransmit(uint64_t in_flight, uint64_t next_seqno) override;
+  void on_timeout(uint64_t in_flight, uint64_t next_seqno, bool repeated) override;
+
+  uint64_t w_max() const { return static_cast<uint64_t>(w_max_ * static_cast<double>(mss_)); } // in seqnos
+
+protected:
+  uint64_t loss_ssthresh(uint64_t in_flight) const override; // max(BETA * cwnd, 2 * MSS)
+
+private:
+  void on_loss();
+  void start_epoch();
+  bool fast_convergence_;
+  double w_max_ {0};           // window before the last reduction, in segments
+  double k_ {0};               // seconds from the start of the epoch until W(t) reaches w_max_
+  double w_est_ {0};           // Reno-friendly window estimate, in segments
+  bool epoch_started_ {false};
+  uint64_t epoch_start_ms_ {0};
+  double growth_carry_ {0};    // fractional seqnos of growth not yet added to cwnd_
+};
+
+// The policy for `algorithm`, or nullptr for CongestionControlAlgorithm::None.
+std::unique_ptr<CongestionControl> make_congestion_control(CongestionControlAlgorithm algorithm,
+                                                           uint64_t mss,
+                                                           bool cubic_fast_convergence = true);
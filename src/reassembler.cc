@@ -1,82 +1,97 @@
 #include "reassembler.hh"
-#include <iostream>
-#include <sstream>
+
+#include <algorithm>
 
 using namespace std;
 
 void Reassembler::insert( uint64_t first_index, string data, bool is_last_substring, Writer& output )
 {
-  // Your code here.
-  if (_bitmap.empty()) {
-    // 初始化
-    _bitmap = std::deque<bool>(output.available_capacity(), false);
-    _pending = std::deque<char>(output.available_capacity(), '\0');
+  const auto [begin, end] = _clip(first_index, data.size(), is_last_substring, output);
+  if (begin < end) {
+    // 裁掉已经组装的前缀和超出窗口的后缀
+    data.resize(end - first_index);
+    data.erase(0, begin - first_index);
+    _assemble(begin, std::move(data), output);
   }
-  if (output.is_closed()) return;
-  if (is_last_substring) _eof = true;
-  uint64_t len = data.size();
-  uint64_t real_len;  // trim后的数据长度
-  uint64_t offset;    // 相对于base的偏移
-  if (len == 0 && _eof && bytes_pending() == 0) {
-    output.close();
-    return;
+  _close_if_done(output);
+}
+
+void Reassembler::insert( uint64_t first_index, string_view data, bool is_last_substring, Writer& output )
+{
+  const auto [begin, end] = _clip(first_index, data.size(), is_last_substring, output);
+  if (begin < end) {
+    // 只拷贝窗口内的字节
+    _assemble(begin, string(data.substr(begin - first_index, end - begin)), output);
+  }
+  _close_if_done(output);
+}
+
+void Reassembler::insert( uint64_t first_index, Buffer data, bool is_last_substring, Writer& output )
+{
+  if (data.unique()) {
+    // 没有其他引用，直接接管底层字符串
+    insert(first_index, data.release(), is_last_substring, output);
+  } else {
+    insert(first_index, static_cast<string_view>(data), is_last_substring, output);
   }
-  if (first_index >= _uass_base + output.available_capacity()) return;
-  if (first_index >= _uass_base) {
-    // 需要pending
-    offset = first_index - _uass_base;
-    real_len = min(len, output.available_capacity() - offset);
-    if (real_len < len) _eof = false; // 数据未完
-    for (uint64_t i=0; i<real_len; i++) {
-      if (_bitmap[i + offset]) continue;
-      _pending[i + offset] = data[i];
-      _bitmap[i + offset] = true;
-    }
-  } else if (first_index + len > _uass_base) {
-    // 存在有效数据
-    offset = _uass_base - first_index;
-    real_len = min(len - offset, output.available_capacity());
-    if (real_len < len - offset) _eof = false; // 数据未完
-    for (uint64_t i=0; i<real_len; i++) {
-      if (_bitmap[i]) continue;
-      _bitmap[i] = true;
-      _pending[i] = data[i + offset];
-    }
+}
+
+pair<uint64_t, uint64_t> Reassembler::_clip(uint64_t first_index, uint64_t len, bool is_last, const Writer& output)
+{
+  if (output.is_closed()) return {0, 0};
+  if (is_last) _end_index = first_index + len;
+
+  // 可接收的窗口: [_uass_base, _uass_base + available_capacity)
+  const uint64_t window_end = _uass_base + output.available_capacity();
+  const uint64_t last = first_index + len;
+
+  // 统计已经组装过的前缀和窗口外的后缀
+  if (len > 0 && last <= _uass_base) _stats.late_segments++;
+  _stats.duplicate_bytes += min(last, _uass_base) - min(first_index, _uass_base);
+  if (last > window_end) _stats.out_of_window_bytes += last - max(first_index, window_end);
+  return {max(first_index, _uass_base), min(last, window_end)};
+}
+
+void Reassembler::_assemble(uint64_t first_index, string data, Writer& output)
+{
+  const uint64_t len = data.size();
+  const uint64_t known_before = _uass_base + _storage.bytes_pending();
+  if (first_index == _uass_base && _storage.empty()) {
+    // 顺序到达且没有缓存的数据：直接把字符串交给Writer
+    _uass_base += data.size();
+    output.push(std::move(data));
+  } else {
+    _storage.insert(_uass_base, first_index, std::move(data));
+    _try_push(output);
   }
-  else {
-    // 过期
+
+  // 已组装和已缓存的字节总数的增量就是新字节数，其余都是重复
+  const uint64_t accepted = _uass_base + _storage.bytes_pending() - known_before;
+  _stats.bytes_accepted += accepted;
+  _stats.duplicate_bytes += len - accepted;
+  if (!_storage.empty()) {
+    // 每个缓存的段前面都有一个空洞
+    _stats.max_holes = max(_stats.max_holes, _storage.segment_count(_uass_base));
+    _stats.peak_pending = max(_stats.peak_pending, _storage.bytes_pending());
   }
+}
 
-  _try_push(output);
-  if (_eof && bytes_pending() == 0) {
+void Reassembler::_close_if_done(Writer& output)
+{
+  if (_end_index.has_value() && _uass_base == _end_index.value()) {
     output.close();
   }
 }
 
 void Reassembler::_try_push(Writer& output) {
-  std::stringstream ss;
-  while (!_bitmap.empty() && _bitmap.front()) {
-    ss << _pending.front();
-    _pending.pop_front();
-    _bitmap.pop_front();
-    _pending.push_back('\0');
-    _bitmap.push_back(false);
-  }
-  std::string tmp = ss.str();
-  if (!tmp.empty()) {
-    output.push(tmp);
-    _uass_base += tmp.size();
+  string ready = _storage.pop(_uass_base);
+  if (!ready.empty()) {
+    _uass_base += ready.size();
+    output.push(std::move(ready));
   }
 }
 
-
-
 uint64_t Reassembler::bytes_pending() const
 {
-  // Your code here.
-  uint64_t count = 0;
-  for (const auto& i: _bitmap) {
-    count += i;
-  }
-  return count;
+  return _storage.bytes_pending();
 }
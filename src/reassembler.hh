@@ -1,10 +1,38 @@
 #pragma once
 
+#include "buffer.hh"
 #include "byte_stream.hh"
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
 
+// Build with -DMINNOW_BITMAP_REASSEMBLER=ON to store out-of-order bytes in a packed bitmap
+// instead of the default segment map.
+#ifdef MINNOW_BITMAP_REASSEMBLER
+#include "bitmap_store.hh"
+using ReassemblerStore = BitmapStore;
+#else
+#include "segment_store.hh"
+using ReassemblerStore = SegmentStore;
+#endif
+
+/*
+ * Counters describing how well the received substrings were used. They are updated
+ * inline by Reassembler::insert and are cheap enough to leave on all the time.
+ */
+struct ReassemblerStats
+{
+  uint64_t bytes_accepted {};      // bytes that were new: written to the stream or stored
+  uint64_t duplicate_bytes {};     // bytes already assembled or already stored when they arrived
+  uint64_t out_of_window_bytes {}; // bytes beyond the stream's available capacity, discarded
+  uint64_t late_segments {};       // non-empty substrings that arrived after all their bytes were assembled
+  uint64_t max_holes {};           // most gaps ever waiting to be filled at once
+  uint64_t peak_pending {};        // most bytes ever stored in the Reassembler at once
+};
 
 class Reassembler
 {
@@ -31,19 +59,44 @@ public:
    */
   void insert( uint64_t first_index, std::string data, bool is_last_substring, Writer& output );
 
+  /*
+   * The same, for substrings the caller doesn't own. Only the bytes that fall inside the
+   * window are copied. A Buffer that nobody else references is moved in without a copy.
+   */
+  void insert( uint64_t first_index, std::string_view data, bool is_last_substring, Writer& output );
+  void insert( uint64_t first_index, Buffer data, bool is_last_substring, Writer& output );
+
   // How many bytes are stored in the Reassembler itself?
   uint64_t bytes_pending() const;
 
+  // Approximately how many bytes of memory does the Reassembler hold for stored data?
+  // This is zero whenever nothing is pending.
+  uint64_t memory_usage() const { return _storage.memory_usage(); }
+
+  // The first `max_count` runs of stored bytes, as [first, last) stream indices in increasing order
+  // (e.g. to report them as SACK blocks)
+  std::vector<std::pair<uint64_t, uint64_t>> pending_ranges( size_t max_count ) const
+  {
+    return _storage.ranges( _uass_base, max_count );
+  }
+
+  // Counters for exporting, e.g. to tune window sizes
+  const ReassemblerStats& stats() const { return _stats; }
+
   uint64_t get_unass_base() const {
     return this->_uass_base;
   }
 
 
 private:
+  // record the end of the stream and clip [first_index, first_index + len) to the window
+  std::pair<uint64_t, uint64_t> _clip(uint64_t first_index, uint64_t len, bool is_last, const Writer& output);
+  void _assemble(uint64_t first_index, std::string data, Writer& output);
+  void _close_if_done(Writer& output);
   void _try_push(Writer& output);
-  bool _eof = false;
-  uint64_t _uass_base = 0;
-  std::deque<char> _pending{};
-  std::deque<bool> _bitmap{};
+  std::optional<uint64_t> _end_index{}; // stream index just past the last byte, once known
+  uint64_t _uass_base = 0;              // first unassembled index
+  ReassemblerStore _storage{};          // bytes that arrived before the bytes preceding them
+  ReassemblerStats _stats{};
 
 };
@@ -0,0 +1,45 @@
+#include "rtt_estimator.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+RTTEstimator::RTTEstimator(uint64_t initial_rto_ms, uint64_t min_rto_ms, uint64_t max_rto_ms)
+  : min_rto_(min_rto_ms)
+  , max_rto_(max(max_rto_ms, min_rto_ms))
+  , rto_(clamp(initial_rto_ms))
+{}
+
+uint64_t RTTEstimator::clamp(uint64_t rto_ms) const
+{
+  return std::clamp(rto_ms, min_rto_, max_rto_);
+}
+
+void RTTEstimator::sample(uint64_t rtt_ms)
+{
+  if (!has_sample_) {
+    // 第一个样本：SRTT = R, RTTVAR = R/2
+    has_sample_ = true;
+    srtt8_ = rtt_ms * 8;
+    rttvar4_ = rtt_ms * 2;
+  } else {
+    const uint64_t srtt = srtt8_ / 8;
+    const uint64_t delta = srtt > rtt_ms ? srtt - rtt_ms : rtt_ms - srtt;
+    rttvar4_ = rttvar4_ - rttvar4_ / 4 + delta;
+    srtt8_ = srtt8_ - srtt8_ / 8 + rtt_ms;
+  }
+  // 时钟粒度为1ms
+  rto_ = clamp(srtt8_ / 8 + max(rttvar4_, uint64_t{1}));
+}
+
+optional<uint64_t> RTTEstimator::srtt() const
+{
+  if (!has_sample_) return nullopt;
+  return srtt8_ / 8;
+}
+
+optional<uint64_t> RTTEstimator::rttvar() const
+{
+  if (!has_sample_) return nullopt;
+  return rttvar4_ / 4;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+/*
+ * RTTEstimator: the RFC 6298 retransmission-timeout calculation. Each round-trip sample
+ * updates the smoothed RTT and its mean deviation,
+ *
+ *   RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|,  SRTT = 7/8 SRTT + 1/8 R,  RTO = SRTT + 4 RTTVAR,
+ *
+ * kept as scaled integers (8 * SRTT and 4 * RTTVAR) so no precision is lost between samples.
+ * Until the first sample the RTO is the initial value. The RTO is always clamped to
+ * [min_rto_ms, max_rto_ms].
+ */
+class RTTEstimator
+{
+public:
+  RTTEstimator(uint64_t initial_rto_ms, uint64_t min_rto_ms, uint64_t max_rto_ms);
+
+  void sample(uint64_t rtt_ms);
+
+  uint64_t rto() const { return rto_; }
+  std::optional<uint64_t> srtt() const; // empty before the first sample
+  std::optional<uint64_t> rttvar() const;
+
+  uint64_t clamp(uint64_t rto_ms) const; // limit a (backed-off) RTO to the configured bounds
+
+private:
+  uint64_t min_rto_;
+  uint64_t max_rto_;
+  uint64_t rto_;
+  bool has_sample_ {false};
+  uint64_t srtt8_ {0};   // 8 * SRTT
+  uint64_t rttvar4_ {0}; // 4 * RTTVAR
+};
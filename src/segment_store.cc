@@ -0,0 +1,73 @@
+#include "segment_store.hh"
+
+#include <iterator>
+
+using namespace std;
+
+void SegmentStore::insert(uint64_t /* base */, uint64_t first_index, string data)
+{
+  // 与前一个段重叠或相邻时并入前一个段
+  auto it = _segments.upper_bound(first_index);
+  if (it != _segments.begin()) {
+    auto prev = std::prev(it);
+    const uint64_t prev_end = prev->first + prev->second.size();
+    if (prev_end >= first_index + data.size()) return; // 完全重复
+    if (prev_end >= first_index) {
+      _account(prev->second, false);
+      prev->second.append(data, prev_end - first_index);
+      data = std::move(prev->second);
+      first_index = prev->first;
+      it = _segments.erase(prev);
+    }
+  }
+
+  // 吞并被新段覆盖或与之相邻的后续段
+  while (it != _segments.end() && it->first <= first_index + data.size()) {
+    const uint64_t data_end = first_index + data.size();
+    if (it->first + it->second.size() > data_end) {
+      data.append(it->second, data_end - it->first);
+    }
+    _account(it->second, false);
+    it = _segments.erase(it);
+  }
+
+  // 裁剪后的字符串可能仍占着原来的大块内存，只保留实际存储的字节
+  if (data.capacity() > 2 * data.size()) {
+    data.shrink_to_fit();
+  }
+  _account(data, true);
+  _segments.emplace_hint(it, first_index, std::move(data));
+}
+
+string SegmentStore::pop(uint64_t base)
+{
+  // 相邻的段在插入时已经合并，所以从base开始的数据最多只有一段
+  if (_segments.empty() || _segments.begin()->first != base) return {};
+  auto node = _segments.extract(_segments.begin());
+  _account(node.mapped(), false);
+  return std::move(node.mapped());
+}
+
+vector<pair<uint64_t, uint64_t>> SegmentStore::ranges(uint64_t /* base */, size_t max_count) const
+{
+  vector<pair<uint64_t, uint64_t>> result;
+  for (const auto& [first_index, data] : _segments) {
+    if (result.size() == max_count) break;
+    result.emplace_back(first_index, first_index + data.size());
+  }
+  return result;
+}
+
+void SegmentStore::_account(const string& segment, bool add)
+{
+  // map节点本身（红黑树指针+键值对）加上字符串的堆内存
+  constexpr uint64_t node_overhead = sizeof(decltype(_segments)::value_type) + 4 * sizeof(void*);
+  const uint64_t footprint = node_overhead + segment.capacity();
+  if (add) {
+    _pending_bytes += segment.size();
+    _memory_bytes += footprint;
+  } else {
+    _pending_bytes -= segment.size();
+    _memory_bytes -= footprint;
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * SegmentStore: the Reassembler's default storage for bytes that arrived ahead of the
+ * first unassembled index. It keeps an ordered map of non-overlapping segments keyed by
+ * stream index, so memory is proportional to the bytes actually held.
+ */
+class SegmentStore
+{
+public:
+  // Store `data` at `first_index` (with `first_index` >= `base`, the first unassembled index)
+  void insert(uint64_t base, uint64_t first_index, std::string data);
+
+  // Remove and return the stored bytes that start exactly at `base` (empty if there are none)
+  std::string pop(uint64_t base);
+
+  bool empty() const { return _segments.empty(); }
+  uint64_t bytes_pending() const { return _pending_bytes; }
+  uint64_t memory_usage() const { return _memory_bytes; }
+  uint64_t segment_count(uint64_t /* base */) const { return _segments.size(); } // separate runs of stored bytes
+
+  // The first `max_count` runs of stored bytes, as [first, last) stream indices in increasing order
+  std::vector<std::pair<uint64_t, uint64_t>> ranges(uint64_t base, size_t max_count) const;
+
+private:
+  void _account(const std::string& segment, bool add);
+  std::map<uint64_t, std::string> _segments{}; // stored bytes: non-overlapping segments keyed by first index
+  uint64_t _pending_bytes = 0;                 // total size of _segments
+  uint64_t _memory_bytes = 0;                  // _segments' allocations, including per-node overhead
+};
@@ -0,0 +1,129 @@
+#include "spsc_byte_stream.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using namespace std;
+
+SPSCByteStream::SPSCByteStream( uint64_t capacity )
+  : capacity_( capacity )
+  , mask_( bit_ceil( max( capacity, uint64_t { 1 } ) ) - 1 )
+  , ring_( make_unique<char[]>( mask_ + 1 ) ) // NOLINT(*-avoid-c-arrays)
+{}
+
+void SPSCWriter::push( string_view data )
+{
+  if ( is_closed() ) {
+    return;
+  }
+  const uint64_t len = min( static_cast<uint64_t>( data.size() ), available_capacity() );
+  if ( len == 0 ) {
+    return;
+  }
+
+  // Only this thread writes tail_, so a relaxed load sees our own latest value.
+  const uint64_t tail = tail_.load( memory_order_relaxed );
+  const uint64_t pos = tail & mask_;
+  const uint64_t first = min( len, mask_ + 1 - pos );
+  memcpy( ring_.get() + pos, data.data(), first );
+  memcpy( ring_.get(), data.data() + first, len - first );
+
+  // Publish the bytes to the reader.
+  tail_.store( tail + len, memory_order_release );
+}
+
+void SPSCWriter::close()
+{
+  is_close_.store( true, memory_order_release );
+}
+
+void SPSCWriter::set_error()
+{
+  has_error_.store( true, memory_order_release );
+}
+
+bool SPSCWriter::is_closed() const
+{
+  return is_close_.load( memory_order_acquire );
+}
+
+uint64_t SPSCWriter::available_capacity() const
+{
+  // Acquire pairs with the reader's release in pop(), so the freed bytes are no longer being read.
+  return capacity_ - ( tail_.load( memory_order_relaxed ) - head_.load( memory_order_acquire ) );
+}
+
+uint64_t SPSCWriter::bytes_pushed() const
+{
+  return tail_.load( memory_order_relaxed );
+}
+
+string_view SPSCReader::peek() const
+{
+  const uint64_t head = head_.load( memory_order_relaxed );
+  const uint64_t buffered = tail_.load( memory_order_acquire ) - head;
+  const uint64_t pos = head & mask_;
+  return { ring_.get() + pos, min( buffered, mask_ + 1 - pos ) };
+}
+
+void SPSCReader::pop( uint64_t len )
+{
+  const uint64_t head = head_.load( memory_order_relaxed );
+  len = min( len, tail_.load( memory_order_acquire ) - head );
+  // Hand the space back to the writer.
+  head_.store( head + len, memory_order_release );
+}
+
+bool SPSCReader::is_finished() const
+{
+  // The writer stores its final tail_ before closing, so once the close is visible so is every byte.
+  return is_close_.load( memory_order_acquire ) and bytes_buffered() == 0;
+}
+
+bool SPSCReader::has_error() const
+{
+  return has_error_.load( memory_order_acquire );
+}
+
+uint64_t SPSCReader::bytes_buffered() const
+{
+  return tail_.load( memory_order_acquire ) - head_.load( memory_order_relaxed );
+}
+
+uint64_t SPSCReader::bytes_popped() const
+{
+  return head_.load( memory_order_relaxed );
+}
+
+SPSCReader& SPSCByteStream::reader()
+{
+  static_assert( sizeof( SPSCReader ) == sizeof( SPSCByteStream ),
+                 "Please add member variables to the SPSCByteStream base, not the SPSCReader." );
+
+  return static_cast<SPSCReader&>( *this ); // NOLINT(*-downcast)
+}
+
+const SPSCReader& SPSCByteStream::reader() const
+{
+  static_assert( sizeof( SPSCReader ) == sizeof( SPSCByteStream ),
+                 "Please add member variables to the SPSCByteStream base, not the SPSCReader." );
+
+  return static_cast<const SPSCReader&>( *this ); // NOLINT(*-downcast)
+}
+
+SPSCWriter& SPSCByteStream::writer()
+{
+  static_assert( sizeof( SPSCWriter ) == sizeof( SPSCByteStream ),
+                 "Please add member variables to the SPSCByteStream base, not the SPSCWriter." );
+
+  return static_cast<SPSCWriter&>( *this ); // NOLINT(*-downcast)
+}
+
+const SPSCWriter& SPSCByteStream::writer() const
+{
+  static_assert( sizeof( SPSCWriter ) == sizeof( SPSCByteStream ),
+                 "Please add member variables to the SPSCByteStream base, not the SPSCWriter." );
+
+  return static_cast<const SPSCWriter&>( *this ); // NOLINT(*-downcast)
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class SPSCReader;
+class SPSCWriter;
+
+/*
+ * SPSCByteStream: a ByteStream that may be written by one thread and read by another at the same time.
+ *
+ * The bytes live in a power-of-two ring indexed by two monotonically increasing counters: the writer
+ * only advances `tail_` and the reader only advances `head_`, so neither side takes a lock. Each side
+ * publishes its counter with a release store and reads the other's with an acquire load; the closed
+ * and error flags are published the same way. At most one thread may use the writer() and at most
+ * one thread may use the reader().
+ */
+class SPSCByteStream
+{
+protected:
+  uint64_t capacity_;             // logical capacity, as passed to the constructor
+  uint64_t mask_;                 // ring size minus one (ring size is capacity_ rounded up to a power of two)
+  std::unique_ptr<char[]> ring_;  // NOLINT(*-avoid-c-arrays)
+  alignas( 64 ) std::atomic<uint64_t> head_ { 0 }; // total bytes popped; written only by the reader
+  alignas( 64 ) std::atomic<uint64_t> tail_ { 0 }; // total bytes pushed; written only by the writer
+  alignas( 64 ) std::atomic<bool> is_close_ { false };
+  std::atomic<bool> has_error_ { false };
+
+public:
+  explicit SPSCByteStream( uint64_t capacity );
+
+  // Helper functions to access the SPSCByteStream's Reader and Writer interfaces
+  SPSCReader& reader();
+  const SPSCReader& reader() const;
+  SPSCWriter& writer();
+  const SPSCWriter& writer() const;
+};
+
+class SPSCWriter : public SPSCByteStream
+{
+public:
+  void push( std::string_view data ); // Push data to stream, but only as much as available capacity allows.
+
+  void close();     // Signal that the stream has reached its ending. Nothing more will be written.
+  void set_error(); // Signal that the stream suffered an error.
+
+  bool is_closed() const;              // Has the stream been closed?
+  uint64_t available_capacity() const; // How many bytes can be pushed to the stream right now?
+  uint64_t bytes_pushed() const;       // Total number of bytes cumulatively pushed to the stream
+};
+
+class SPSCReader : public SPSCByteStream
+{
+public:
+  std::string_view peek() const; // Peek at the next contiguous bytes in the buffer
+  void pop( uint64_t len );      // Remove `len` bytes from the buffer
+
+  bool is_finished() const; // Is the stream finished (closed and fully popped)?
+  bool has_error() const;   // Has the stream had an error?
+
+  uint64_t bytes_buffered() const; // Number of bytes currently buffered (pushed and not popped)
+  uint64_t bytes_popped() const;   // Total number of bytes cumulatively popped from stream
+};
@@ -1,35 +1,165 @@
 #include "tcp_receiver.hh"
+#include "trace.hh"
+
+#include <algorithm>
 #include <random>
-#include <iostream>
 
 using namespace std;
 
+TCPReceiver::TCPReceiver(const TCPConfig& config)
+{
+  if (config.window_scaling) set_window_scale(config.window_shift());
+  if (config.delayed_ack) set_delayed_ack(config.delayed_ack_timeout_ms, config.mss);
+  if (config.recv_autotuning) {
+    set_autotuning(config.recv_capacity_min, config.recv_capacity_max, config.recv_idle_ms);
+  }
+}
+
 void TCPReceiver::receive( TCPSenderMessage message, Reassembler& reassembler, Writer& inbound_stream )
 {
   if (message.SYN && !_syn) {
     // 设置ISN
     _isn = Wrap32(message.seqno);
     _syn = true;
+    _peer_mss = message.mss;
+    _peer_wscale = message.window_scale;
   }
   if (!_syn) return;
+  // 纯ack（不占序号）不需要回ack
+  const bool occupies = message.sequence_length() > 0;
+  const bool flags = message.SYN || message.FIN;
+  const uint64_t payload_size = message.payload.size();
   uint64_t abs_no = message.seqno.unwrap(_isn, reassembler.get_unass_base());
-  if (!message.SYN && abs_no == 0) return;
+  if (!message.SYN && abs_no == 0) {
+    _ack_now = _ack_now || occupies;
+    return;
+  }
   uint64_t stream_no = abs_no > 0 ? abs_no - 1 : 0;
-  std::string &data = message.payload;
-  reassembler.insert(stream_no, data, message.FIN, inbound_stream);
+  const uint64_t base_before = reassembler.get_unass_base();
+  const bool had_gap = reassembler.bytes_pending() > 0;
+  reassembler.insert(stream_no, std::move(message.payload), message.FIN, inbound_stream);
   _fin = inbound_stream.is_closed();
-  std::cout << reassembler.get_unass_base() << "\t" << abs_no << "\t" << stream_no << std::endl;
+  if (occupies) {
+    on_segment(reassembler.get_unass_base() - base_before, flags || had_gap || reassembler.bytes_pending() > 0);
+  }
+  update_sack(reassembler, payload_size > 0 ? optional{max(stream_no, base_before)} : nullopt);
+  MINNOW_TRACE(Receiver, "receive abs_seqno,stream_index,assembled",
+               abs_no, stream_no, reassembler.get_unass_base());
+}
+
+void TCPReceiver::update_sack(const Reassembler& reassembler, optional<uint64_t> newest)
+{
+  // 缺口之后已收到的区间作为SACK块告知发送方。按RFC 2018，第一个块是包含最新到达报文的区间，
+  // 其后是上次报告过、仍未重组的块，剩余位置再按序号从小到大补齐
+  const auto ranges = reassembler.pending_ranges(SIZE_MAX);
+  vector<pair<uint64_t, uint64_t>> order;
+  const auto add = [&](uint64_t index) {
+    if (order.size() == TCPReceiverMessage::MAX_SACK_BLOCKS) return;
+    auto it = upper_bound(ranges.begin(), ranges.end(), index,
+                          [](uint64_t i, const pair<uint64_t, uint64_t>& r) { return i < r.first; });
+    if (it == ranges.begin() || index >= prev(it)->second) return;
+    if (find(order.begin(), order.end(), *prev(it)) == order.end()) order.push_back(*prev(it));
+  };
+  if (newest.has_value()) add(*newest);
+  for (const auto& [first, last] : _sack_ranges) add(first);
+  for (const auto& [first, last] : ranges) add(first);
+
+  _sack_ranges = std::move(order);
+  _sack.clear();
+  for (const auto& [first, last] : _sack_ranges) {
+    _sack.push_back({Wrap32::wrap(first + 1, _isn), Wrap32::wrap(last + 1, _isn)});
+  }
+}
+
+void TCPReceiver::on_segment(uint64_t advanced, bool urgent)
+{
+  // 乱序、重复、填补缺口或带SYN/FIN的报文立即ack（RFC 5681 4.2）
+  if (!_ack_delay.has_value() || urgent || advanced == 0) {
+    _ack_now = true;
+    return;
+  }
+  _unacked_bytes += advanced;
+  if (_unacked_bytes >= 2 * _mss) {
+    _ack_now = true;
+  } else if (!_delack_timer.has_value()) {
+    _delack_timer = 0;
+  }
+}
+
+void TCPReceiver::set_delayed_ack(uint64_t timeout_ms, uint16_t mss)
+{
+  _ack_delay = timeout_ms;
+  _mss = mss;
+}
+
+void TCPReceiver::set_autotuning(uint64_t min_capacity, uint64_t max_capacity, uint64_t idle_ms)
+{
+  _tuner.emplace(min_capacity, max_capacity, idle_ms);
+}
+
+void TCPReceiver::set_rtt(uint64_t rtt_ms)
+{
+  if (_tuner.has_value()) _tuner->set_rtt(rtt_ms);
+}
+
+void TCPReceiver::tick(uint64_t ms_since_last_tick, const Reassembler& reassembler, Writer& inbound_stream)
+{
+  if (_delack_timer.has_value()) {
+    *_delack_timer += ms_since_last_tick;
+    if (*_delack_timer >= *_ack_delay) _ack_now = true;
+  }
+  if (!_tuner.has_value() || !_syn) return;
+  const Reader& reader = inbound_stream.reader();
+  const uint64_t current = inbound_stream.capacity();
+  const uint64_t tuned = _tuner->tick(ms_since_last_tick, inbound_stream.bytes_pushed(), reader.bytes_popped(),
+                                      reader.bytes_buffered(), current);
+  // 已通告的窗口不能收回（RFC 9293 3.8.6），缩小只能还回从未通告过的部分
+  const uint64_t promised = _advertised_edge - min(_advertised_edge, inbound_stream.bytes_pushed());
+  const uint64_t capacity = max(tuned, reader.bytes_buffered() + promised);
+  // 重组器里还有乱序数据时不缩小，否则它们重组时会被截断
+  if (capacity == current || (capacity < current && reassembler.bytes_pending() > 0)) return;
+  MINNOW_TRACE(Receiver, "autotune capacity,was", capacity, current);
+  inbound_stream.set_capacity(capacity);
+}
+
+optional<TCPReceiverMessage> TCPReceiver::maybe_send(const Writer& inbound_stream)
+{
+  if (!_syn) return nullopt;
+  // 窗口从很小重新打开到min(MSS, 缓冲区一半)以上时要通知发送方，
+  // 否则它只能靠零窗口探测（RFC 1122 4.2.3.3）
+  const uint64_t window = inbound_stream.available_capacity();
+  _max_window = max(_max_window, window);
+  const uint64_t threshold = min(_mss, _max_window / 2);
+  const bool reopened = _advertised_window < threshold && window >= threshold;
+  if (!_ack_now && !reopened) return nullopt;
+  _ack_now = false;
+  _unacked_bytes = 0;
+  _delack_timer.reset();
+  _advertised_window = window;
+  MINNOW_TRACE(Receiver, "ack window,reopened", window, reopened);
+  return send(inbound_stream);
+}
+
+uint8_t TCPReceiver::window_shift() const
+{
+  return _wscale.has_value() && _peer_wscale.has_value() ? *_wscale : 0;
 }
 
 TCPReceiverMessage TCPReceiver::send( const Writer& inbound_stream ) const
 {
-  uint16_t window_size_ = inbound_stream.available_capacity() < UINT16_MAX ? inbound_stream.available_capacity() : UINT16_MAX;
+  // 协商了窗口缩放时，通告的是右移后的窗口
+  const uint64_t window = inbound_stream.available_capacity() >> window_shift();
+  uint16_t window_size_ = window < UINT16_MAX ? window : UINT16_MAX;
+  // 记下通告过的窗口右沿，自动调整缩小缓冲区时不能收回它
+  const uint64_t edge = inbound_stream.bytes_pushed() + (uint64_t{window_size_} << window_shift());
+  _advertised_edge = max(_advertised_edge, edge);
   if (_syn) {
     Wrap32 ackno_ = Wrap32::wrap(inbound_stream.bytes_pushed(), _isn) + 1 + _fin;
-    std::cout << inbound_stream.bytes_pushed() << "\t" << window_size_ << std::endl;
+    MINNOW_TRACE(Receiver, "send bytes_pushed,window", inbound_stream.bytes_pushed(), window_size_);
     return TCPReceiverMessage {
         ackno_,
-        window_size_
+        window_size_,
+        _sack
       };
   } else {
     return TCPReceiverMessage {
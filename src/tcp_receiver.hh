@@ -1,12 +1,24 @@
 #pragma once
 
 #include "reassembler.hh"
+#include "tcp_config.hh"
 #include "tcp_receiver_message.hh"
 #include "tcp_sender_message.hh"
+#include "window_tuner.hh"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class TCPReceiver
 {
 public:
+  TCPReceiver() = default;
+
+  /* Construct a TCPReceiver from a TCPConfig (window-scale offer, delayed acks and auto-tuning) */
+  explicit TCPReceiver( const TCPConfig& config );
+
   /*
    * The TCPReceiver receives TCPSenderMessages, inserting their payload into the Reassembler
    * at the correct stream index.
@@ -16,8 +28,61 @@ public:
   /* The TCPReceiver sends TCPReceiverMessages back to the TCPSender. */
   TCPReceiverMessage send( const Writer& inbound_stream ) const;
 
+  /*
+   * The ack to transmit now, if one is due: after every segment that occupies sequence space, or, with
+   * delayed acks, after every second full segment. Out-of-order data, SYN, FIN and a window reopening
+   * are always acked at once.
+   */
+  std::optional<TCPReceiverMessage> maybe_send( const Writer& inbound_stream );
+
+  /* Delay acks for in-order data by up to timeout_ms (RFC 1122 4.2.3.2); mss is the full segment size. */
+  void set_delayed_ack( uint64_t timeout_ms, uint16_t mss );
+
+  /*
+   * Time has passed by the given # of milliseconds since the last time tick() was called. This drives
+   * the delayed-ack timer and, with auto-tuning, resizes the inbound stream.
+   */
+  void tick( uint64_t ms_since_last_tick, const Reassembler& reassembler, Writer& inbound_stream );
+
+  /* Resize the inbound stream within [min_capacity, max_capacity] to follow the application's drain rate. */
+  void set_autotuning( uint64_t min_capacity, uint64_t max_capacity, uint64_t idle_ms );
+
+  /* The connection's RTT (e.g. TCPSender::srtt_ms()), which paces auto-tuning. */
+  void set_rtt( uint64_t rtt_ms );
+
+  /* The MSS option carried by the peer's SYN, if it had one (for TCPSender::set_peer_mss). */
+  std::optional<uint16_t> peer_mss() const { return _peer_mss; }
+
+  /* Our SYN offered this window-scale shift (TCPConfig::window_shift()); it applies if the peer's SYN did too. */
+  void set_window_scale( uint8_t shift ) { _wscale = shift; }
+
+  /* The window-scale option carried by the peer's SYN (for TCPSender::set_peer_window_scale). */
+  std::optional<uint8_t> peer_window_scale() const { return _peer_wscale; }
+
+  /* The shift applied to the windows this receiver advertises (0 unless scaling was negotiated). */
+  uint8_t window_shift() const;
+
 private:
+  void on_segment( uint64_t advanced, bool urgent );
+  void update_sack( const Reassembler& reassembler, std::optional<uint64_t> newest );
+
   Wrap32 _isn{ 0 };
   bool _syn = false;
   bool _fin = false;
+  std::vector<SackBlock> _sack{}; // 乱序到达、尚未重组的区间
+  std::vector<std::pair<uint64_t, uint64_t>> _sack_ranges{}; // 同上，按流下标，保持报告顺序
+  std::optional<uint16_t> _peer_mss{};
+  std::optional<uint8_t> _wscale{};
+  std::optional<uint8_t> _peer_wscale{};
+  // 延迟ack
+  std::optional<uint64_t> _ack_delay{};    // 为空时每个报文立即ack
+  uint64_t _mss = TCPConfig::MAX_PAYLOAD_SIZE;
+  bool _ack_now = false;
+  uint64_t _unacked_bytes = 0;             // 已按序收到、尚未ack的字节数
+  std::optional<uint64_t> _delack_timer{}; // 延迟ack计时，未计时为空
+  uint64_t _advertised_window = 0;         // 上一个ack通告的窗口（未缩放）
+  uint64_t _max_window = 0;                // 见过的最大窗口，近似缓冲区大小
+  mutable uint64_t _advertised_edge = 0;   // 通告过的最远窗口右沿（流下标）
+  // 接收缓冲区自动调整，未开启为空
+  std::optional<WindowTuner> _tuner{};
 };
@@ -1,13 +1,17 @@
 #include "tcp_sender.hh"
 #include "tcp_config.hh"
 
+#include "trace.hh"
+
+#include <algorithm>
 #include <random>
-#include <iostream>
 
 using namespace std;
 
 /* TCPSender constructor (uses a random ISN if none given) */
-TCPSender::TCPSender( uint64_t initial_RTO_ms, optional<Wrap32> fixed_isn )
+TCPSender::TCPSender( uint64_t initial_RTO_ms,
+                      optional<Wrap32> fixed_isn,
+                      unique_ptr<CongestionControl> congestion_control )
   :
    isn_( fixed_isn.value_or( Wrap32 { random_device()() } ) )
   , initial_RTO_ms_( initial_RTO_ms )
@@ -21,15 +25,124 @@ TCPSender::TCPSender( uint64_t initial_RTO_ms, optional<Wrap32> fixed_isn )
   , rto_(initial_RTO_ms)
   , timer_()
   , outstanding_({})
+  , next_unsent_(0)
+  , retransmit_front_(false)
+  , seqnos_in_flight_(0)
+  , cc_(std::move(congestion_control))
+  , local_mss_(TCPConfig::MAX_PAYLOAD_SIZE)
+  , path_mss_(TCPConfig::MAX_PAYLOAD_SIZE)
+  , mss_(TCPConfig::MAX_PAYLOAD_SIZE)
 {}
 
-uint64_t TCPSender::sequence_numbers_in_flight() const
+TCPSender::TCPSender( const TCPConfig& config )
+  : TCPSender( config.rt_timeout,
+               config.fixed_isn,
+               make_congestion_control( config.congestion_control,
+                                        std::max<uint64_t>( config.mss, 1 ),
+                                        config.cubic_fast_convergence ) )
+{
+  if (config.adaptive_rto) {
+    rtt_.emplace(config.rt_timeout, config.rto_min_ms, config.rto_max_ms);
+    rto_ = rtt_->rto();
+  }
+  if (config.nagle) {
+    nagle_timeout_ = config.nagle_timeout_ms;
+  }
+  local_mss_ = path_mss_ = mss_ = max<uint64_t>(config.mss, 1);
+  super_segment_size_ = config.super_segment_size;
+  pmtu_probing_ = config.pmtu_probing;
+  pmtu_interval_ms_ = config.pmtu_probe_interval_ms;
+  if (config.window_scaling) {
+    wscale_offer_ = config.window_shift();
+  }
+}
+
+void TCPSender::set_peer_window_scale( uint8_t shift )
 {
-  uint64_t n = 0;
-  for (const auto& p: outstanding_) {
-    n += p.second.sequence_length();
+  // 双方的SYN都带了窗口缩放选项才生效
+  if (wscale_offer_) {
+    peer_shift_ = min(shift, TCPConfig::MAX_WINDOW_SHIFT);
   }
-  return n;
+}
+
+void TCPSender::set_peer_mss( uint16_t peer_mss )
+{
+  path_mss_ = max<uint64_t>(min<uint64_t>(local_mss_, peer_mss), 1);
+  // 通常在发送数据之前协商，这时按新的MSS重算初始窗口
+  set_mss(path_mss_, checkpoint_ <= 1);
+}
+
+void TCPSender::set_mss(uint64_t mss, bool reset_window)
+{
+  mss_ = mss;
+  if (cc_) cc_->set_mss(mss, reset_window);
+}
+
+void TCPSender::shrink_mss()
+{
+  // 满长报文屡次超时，可能是路径MTU黑洞：MSS减半，并把未确认的大报文切小重发
+  set_mss(max<uint64_t>(mss_ / 2, TCPConfig::MIN_MSS), false);
+  MINNOW_TRACE(Sender, "pmtu shrink mss", mss_);
+  pmtu_shrunk_at_ = now_ms_;
+  pmtu_losses_ = 0;
+  resegment();
+}
+
+void TCPSender::resegment()
+{
+  deque<OutstandingSegment> resized;
+  size_t next_unsent = 0;
+  for (size_t i = 0; i < outstanding_.size(); i++) {
+    OutstandingSegment& seg = outstanding_[i];
+    if (seg.msg.payload.size() <= max_payload()) {
+      resized.push_back(std::move(seg));
+      next_unsent += i < next_unsent_;
+      continue;
+    }
+    uint64_t abs_seqno = seg.abs_seqno;
+    for (TCPSenderMessage& piece : split_super_segment(seg.msg, max_payload())) {
+      const uint64_t len = piece.sequence_length();
+      resized.push_back(
+        OutstandingSegment{abs_seqno, std::move(piece), seg.sent_ms, seg.retransmitted, seg.sacked});
+      abs_seqno += len;
+      next_unsent += i < next_unsent_;
+    }
+  }
+  outstanding_ = std::move(resized);
+  next_unsent_ = next_unsent;
+}
+
+vector<TCPSenderMessage> split_super_segment( const TCPSenderMessage& msg, size_t mss )
+{
+  // SYN随第一片，FIN随最后一片，每片的seqno紧接上一片
+  vector<TCPSenderMessage> pieces;
+  const string_view payload = msg.payload;
+  Wrap32 seqno = msg.seqno;
+  size_t offset = 0;
+  do {
+    TCPSenderMessage piece{};
+    piece.seqno = seqno;
+    piece.SYN = msg.SYN && offset == 0;
+    piece.mss = offset == 0 ? msg.mss : nullopt;
+    piece.window_scale = offset == 0 ? msg.window_scale : nullopt;
+    const size_t len = min(mss, payload.size() - offset);
+    piece.payload = string(payload.substr(offset, len));
+    offset += len;
+    piece.FIN = msg.FIN && offset == payload.size();
+    seqno = seqno + static_cast<uint32_t>(piece.sequence_length());
+    pieces.push_back(std::move(piece));
+  } while (offset < payload.size());
+  return pieces;
+}
+
+optional<uint64_t> TCPSender::srtt_ms() const
+{
+  return rtt_ ? rtt_->srtt() : nullopt;
+}
+
+uint64_t TCPSender::sequence_numbers_in_flight() const
+{
+  return seqnos_in_flight_;
 }
 
 uint64_t TCPSender::consecutive_retransmissions() const
@@ -39,58 +152,126 @@ uint64_t TCPSender::consecutive_retransmissions() const
 
 optional<TCPSenderMessage> TCPSender::maybe_send()
 {
-  std::cout << "[MAYBESEND] try to send, outstanding queue size: " << outstanding_.size() 
-            << std::endl;
+  OutstandingSegment* t = nullptr;
+  if (retransmit_front_) {
+    // 超时后重传最早的未确认报文
+    retransmit_front_ = false;
+    t = &outstanding_.front();
+    t->retransmitted = true;
+    if (hole_cursor_) hole_cursor_ = max(*hole_cursor_, t->abs_end());
+  } else if (OutstandingSegment* hole = next_hole()) {
+    // SACK恢复中重传下一个缺口
+    t = hole;
+    t->retransmitted = true;
+  } else if (next_unsent_ < outstanding_.size()) {
+    t = &outstanding_[next_unsent_++];
+    t->sent_ms = now_ms_;
+  } else {
+    return std::nullopt;
+  }
+  if (!timer_.running) timer_.start();
+  MINNOW_TRACE(Sender, "maybe_send seqno,len,queued", t->abs_seqno, t->msg.sequence_length(), outstanding_.size());
+  return t->msg;
+}
 
-  TCPSenderMessage t{};
-  bool has_send = false;
-  for (auto it=outstanding_.begin(); it!=outstanding_.end(); it++) {
-    if (!it->first.already_send) {
-      t = it->second;
-      it->first.already_send = true;
-      has_send = true;
-      break;
+void TCPSender::queue_segment(TCPSenderMessage msg)
+{
+  // 报文按序号连续排列，新报文的绝对序号即为checkpoint_
+  seqnos_in_flight_ += msg.sequence_length();
+  checkpoint_ += msg.sequence_length();
+  outstanding_.push_back(OutstandingSegment{checkpoint_ - msg.sequence_length(), std::move(msg)});
+}
+
+uint64_t TCPSender::next_sent_seqno() const
+{
+  return next_unsent_ < outstanding_.size() ? outstanding_[next_unsent_].abs_seqno : checkpoint_;
+}
+
+size_t TCPSender::sent_index(uint64_t abs_seqno) const
+{
+  const auto sent_end = outstanding_.begin() + static_cast<ptrdiff_t>(next_unsent_);
+  const auto it = partition_point(outstanding_.begin(), sent_end, [abs_seqno](const OutstandingSegment& seg) {
+    return seg.abs_end() <= abs_seqno;
+  });
+  return it - outstanding_.begin();
+}
+
+void TCPSender::mark_sacked(const vector<SackBlock>& blocks)
+{
+  for (const SackBlock& block : blocks) {
+    const uint64_t begin = block.begin.unwrap(isn_, checkpoint_);
+    const uint64_t end = block.end.unwrap(isn_, checkpoint_);
+    if (begin >= end || end > next_sent_seqno()) continue; // 不可能的块
+    highest_sacked_ = max(highest_sacked_, end);
+    // 只标记整个落在块内的报文
+    for (size_t i = sent_index(begin); i < next_unsent_ && outstanding_[i].abs_end() <= end; i++) {
+      if (outstanding_[i].abs_seqno >= begin) outstanding_[i].sacked = true;
     }
   }
-  if (has_send) {
-    std::cout << "send one\n";
-    return t;
-  } else {
-    std::cout << "send nullopt\n";
-    return std::nullopt;
+}
+
+OutstandingSegment* TCPSender::next_hole()
+{
+  if (!hole_cursor_) return nullptr;
+  // 缺口是最高SACK序号以下、没被SACK确认的报文；游标只前进，每个缺口只重传一次
+  size_t i = sent_index(*hole_cursor_);
+  for (; i < next_unsent_ && outstanding_[i].abs_end() <= highest_sacked_; i++) {
+    if (!outstanding_[i].sacked) {
+      hole_cursor_ = outstanding_[i].abs_end();
+      return &outstanding_[i];
+    }
   }
+  hole_cursor_ = i < next_unsent_ ? outstanding_[i].abs_seqno : next_sent_seqno();
+  return nullptr;
+}
+
+bool TCPSender::hold_tail(const Reader& outbound_stream)
+{
+  // Nagle：还有未确认的数据时，不足一个MSS的尾部先留在流里，等ack或超时
+  const bool small_tail = outbound_stream.bytes_buffered() < mss_
+                          && !outbound_stream.writer().is_closed();
+  if (!nagle_timeout_ || !small_tail || outstanding_.empty()) {
+    nagle_since_.reset();
+    return false;
+  }
+  if (!nagle_since_) nagle_since_ = now_ms_;
+  if (now_ms_ - *nagle_since_ >= *nagle_timeout_) {
+    // 扣留超时，这次照常发送
+    nagle_since_.reset();
+    return false;
+  }
+  return true;
 }
 
 void TCPSender::push( Reader& outbound_stream )
 {
-  std::cout << "[PUSH] syn state: " << syn_ 
-            << "\tack syn state: " << ack_syn_
-            << "\tfin state: " << fin_
-            << std::endl;
   if (fin_) return;
   if (!syn_) {
-    std::cout << "push syn data" << std::endl; 
     TCPSenderMessage t{};
     t.seqno = isn_;
     t.SYN = true;
+    t.mss = static_cast<uint16_t>(min<uint64_t>(local_mss_, UINT16_MAX));
+    t.window_scale = wscale_offer_;
     t.FIN = outbound_stream.is_finished();
     this->syn_ = true;
     if (t.FIN) fin_ = true;
-    outstanding_.push_back(std::make_pair(MessageInfo(), t));
-    checkpoint_ += (t.SYN + t.FIN);
+    queue_segment(std::move(t));
     return;
   }
   if (!ack_syn_) return;
 
   uint64_t window_size = window_size_; 
   if (window_size == 0) {
+    // 窗口为0时假装为1，以便探测
     window_size = 1;
-    std::cout << "pretend window size == 1" << std::endl; 
+  }
+  if (cc_) {
+    // 同时受拥塞窗口限制
+    window_size = std::min(window_size, cc_->cwnd());
   }
 
   // 逐个生成message直到用尽容量
   uint64_t available_size = window_size > this->sequence_numbers_in_flight() ? window_size - this->sequence_numbers_in_flight() : 0;
-  std::cout << "available size: " << available_size << std::endl;
   uint64_t sent_size = 0;
   uint64_t pack_size = 0;
   while (available_size > 0) {
@@ -101,19 +282,17 @@ void TCPSender::push( Reader& outbound_stream )
       fin_ = true;
       t.FIN = true;
       sent_size += (t.SYN + t.FIN);
-      checkpoint_ += (t.SYN + t.FIN);
       pack_size ++;
-      outstanding_.push_back(std::make_pair(MessageInfo(), t));
+      queue_segment(std::move(t));
       break;
     }
 
     auto view = outbound_stream.peek();
-    uint64_t send_size = std::min(std::min(view.size(), available_size), TCPConfig::MAX_PAYLOAD_SIZE);
-    if (send_size == 0) break;
+    uint64_t send_size = std::min(std::min(view.size(), available_size), max_payload());
+    if (send_size == 0 || hold_tail(outbound_stream)) break;
     auto data_view = view.substr(0, send_size);
-    std::string data(data_view);
+    t.payload = std::string(data_view);
     outbound_stream.pop(send_size);
-    t.payload = data;
     is_closed = outbound_stream.is_finished();
     bool data_with_fin = false;
     if (is_closed && available_size > send_size) {
@@ -124,18 +303,16 @@ void TCPSender::push( Reader& outbound_stream )
     }
 
     sent_size += send_size;
-    checkpoint_ += send_size;
     pack_size ++;
     available_size -= send_size;
-    outstanding_.push_back(std::make_pair(MessageInfo(), t));
+    queue_segment(std::move(t));
     if (data_with_fin) break;
   }
-  std::cout << "send " << sent_size << " bytes and pack size " << pack_size << std::endl;
+  MINNOW_TRACE(Sender, "push bytes,segments,window", sent_size, pack_size, window_size);
 }
 
 TCPSenderMessage TCPSender::send_empty_message() const
 {
-  std::cout << "[EMPTYSEND]\n";
   TCPSenderMessage t{};
   t.seqno = isn_ + checkpoint_;
   t.payload = std::string("");
@@ -144,83 +321,109 @@ TCPSenderMessage TCPSender::send_empty_message() const
 
 void TCPSender::receive( const TCPReceiverMessage& msg )
 {
-  std::cout << "[RECV]\n";
-  if (msg.ackno.has_value()) {
-    if (!ack_syn_ && msg.ackno.value() == isn_ + 1) {
-      // 第一次响应同步
-      std::cout << "first sync, window_size: " << msg.window_size << std::endl;
-      this->ack_syn_ = true;
-      this->ackno_ = msg.ackno.value();
-      this->window_size_ = msg.window_size;
-    } else {
-      int comp = compare_seqno(ackno_, msg.ackno.value());
-      std::cout << "compare result: " << comp << "\n";
-      if (comp <= 0) {
-        // 仅更新window size
-        std::cout << "set window size: " << msg.window_size << std::endl;
-        this->window_size_ = msg.window_size;
-      }
-      if (comp < 0) {
-        // 数据有效更新
-        this->ackno_ = msg.ackno.value();
-        rto_ = initial_RTO_ms_;
-        // 重置timer and count
-        retrans_count_ = 0;
-        timer_.time_passed = 0;
+  if (!msg.ackno.has_value()) return;
+  // 每次receive只unwrap一次，之后都用绝对序号比较
+  const uint64_t ackno = msg.ackno->unwrap(isn_, checkpoint_);
+  const uint64_t window = uint64_t{msg.window_size} << peer_shift_;
+  MINNOW_TRACE(Sender, "receive ackno,window", ackno, window);
+  if (ackno > next_sent_seqno() || ackno < ackno_) {
+    // 不可能的ackno或过期的ackno
+    return;
+  }
+  mark_sacked(msg.sack);
+  // 重复ack：ackno和窗口都没变，且还有已发送未确认的数据
+  const bool duplicate = ack_syn_ && ackno == ackno_ && window == window_size_ && next_unsent_ > 0;
+  this->window_size_ = window;
+  bool new_data = false;
+  bool retransmit_now = false;
+  if (duplicate) {
+    dup_acks_ ++;
+    if (cc_ && cc_->in_recovery()) {
+      // 快速恢复中每个重复ack代表又有一个报文离开网络
+      cc_->on_duplicate_ack();
+    } else if (dup_acks_ == 3) {
+      // 第三个重复ack：不等超时，立即重传最早的未确认报文
+      MINNOW_TRACE(Sender, "fast retransmit ackno,in_flight,highest_sacked",
+                   ackno_, sent_in_flight(), highest_sacked_);
+      if (highest_sacked_ > ackno_) {
+        // 有SACK信息：重传最高SACK序号以下的所有缺口，而不只是队首
+        hole_cursor_ = ackno_;
+        sack_recover_ = next_sent_seqno();
+      } else {
+        retransmit_front_ = true;
       }
+      if (cc_) cc_->on_fast_retransmit(sent_in_flight(), next_sent_seqno());
     }
+  } else if (ackno > ackno_) {
+    dup_acks_ = 0;
+  }
+  if (ackno > ackno_) {
+    // 数据有效更新
+    // SYN的ack不计入拥塞窗口
+    if (cc_ && ack_syn_) retransmit_now = cc_->on_ack(ackno, ackno - ackno_, sent_in_flight());
+    this->ackno_ = ackno;
+    this->ack_syn_ = true;
+    if (!rtt_) rto_ = initial_RTO_ms_;
+    // 重置count
+    retrans_count_ = 0;
+    pmtu_losses_ = 0;
+    new_data = true;
+    if (hole_cursor_ && ackno_ >= sack_recover_) hole_cursor_.reset();
   }
 
-  if (!ack_syn_) return;
-  // 遍历outstanding，丢掉ack数据包
-  for (auto it=outstanding_.begin(); it!=outstanding_.end();) {
-    if (it->first.already_send && compare_seqno(ackno_, (it->second.seqno + it->second.sequence_length())) >= 0 ) {
-      // 已经ack，丢掉
-      std::cout << "drop ack data" << std::endl;
-      it = outstanding_.erase(it);
-      std::cout << "outstanding size after drop: " << outstanding_.size() << std::endl;
-    } else {
-      it ++;
-    }
+  // 已发送的报文按seqno排序，从队首丢掉ack数据包
+  bool rtt_valid = true;
+  optional<uint64_t> last_sent_ms;
+  while (next_unsent_ > 0 && outstanding_.front().abs_end() <= ackno_) {
+    rtt_valid &= !outstanding_.front().retransmitted;
+    last_sent_ms = outstanding_.front().sent_ms;
+    seqnos_in_flight_ -= outstanding_.front().msg.sequence_length();
+    outstanding_.pop_front();
+    next_unsent_ --;
+    retransmit_front_ = false;
+  }
+  if (rtt_ && rtt_valid && last_sent_ms.has_value()) {
+    // 用最近发送的被确认报文测量RTT；没有有效样本时保留退避后的RTO (Karn)
+    rtt_->sample(now_ms_ - *last_sent_ms);
+    rto_ = rtt_->rto();
+  }
+  if (retransmit_now && next_unsent_ > 0 && (!hole_cursor_ || outstanding_.front().abs_end() > *hole_cursor_)) {
+    // 快速恢复中的部分ack，立即重传下一个缺口（SACK恢复中已重传过的除外）
+    retransmit_front_ = true;
+  }
+  if (next_unsent_ == 0) {
+    // 已发送数据全部确认
+    timer_.stop();
+  } else if (new_data) {
+    timer_.start();
   }
 }
 
 void TCPSender::tick( const size_t ms_since_last_tick )
 {
-  std::cout << "[TICK] for ms " << ms_since_last_tick << std::endl;
-
-  for (auto it=outstanding_.begin(); it!=outstanding_.end();) {
-    // 由远及近遍历outstanding，找出timeout数据包并重发
-    if (ack_syn_ && it->first.already_send && compare_seqno(ackno_, (it->second.seqno + it->second.sequence_length())) >= 0) {
-      // 已经ack，丢掉
-      std::cout << "old data, drop" << std::endl;
-      it = outstanding_.erase(it);
-      std::cout << "outstanding size after drop: " << outstanding_.size() << std::endl;
-    } else {
-      it ++;
-    }
+  now_ms_ += ms_since_last_tick;
+  if (cc_) cc_->on_tick(ms_since_last_tick);
+  if (pmtu_shrunk_at_ && now_ms_ - *pmtu_shrunk_at_ >= pmtu_interval_ms_) {
+    // 过一段时间再试一次完整的MSS，路径可能已经恢复
+    pmtu_shrunk_at_.reset();
+    set_mss(path_mss_, false);
   }
-
-
+  if (!timer_.running) return;
   timer_.time_pass(ms_since_last_tick);
   if (timer_.is_timeout(rto_)) {
-    // timeout
-    std::cout << "timeout, resend, time passed: " << timer_.time_passed
-              << "\trto: " << rto_
-              << std::endl;
-    for (auto it=outstanding_.begin(); it!=outstanding_.end(); it++) {
-      if (it->first.already_send) {
-        it->first.already_send = false;
-        timer_.time_passed = 0;
-        if (!ack_syn_ || window_size_ > 0) {
-          this->retrans_count_ ++;
-          rto_ *= 2;
-          std::cout << "double rto and increase retrans count, now rto: " << rto_
-                    << "\tretrans count: " << retrans_count_
-                    << std::endl;
-        }
-        break;
+    // timeout，计时器只在有已发送未确认报文时运行，所以队首一定已发送
+    MINNOW_TRACE(Sender, "timeout elapsed,rto", timer_.time_passed, rto_);
+    retransmit_front_ = true;
+    hole_cursor_.reset();
+    if (!ack_syn_ || window_size_ > 0) {
+      this->retrans_count_ ++;
+      rto_ = rtt_ ? rtt_->clamp(rto_ * 2) : rto_ * 2;
+      if (cc_ && ack_syn_) cc_->on_timeout(sent_in_flight(), next_sent_seqno(), retrans_count_ > 1);
+      if (pmtu_probing_ && mss_ > TCPConfig::MIN_MSS && outstanding_.front().msg.payload.size() > mss_ / 2
+          && ++pmtu_losses_ >= TCPConfig::PMTU_LOSS_THRESHOLD) {
+        shrink_mss();
       }
     }
+    timer_.start();
   }
 }
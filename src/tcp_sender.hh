@@ -1,14 +1,20 @@
 #pragma once
 
 #include "byte_stream.hh"
+#include "congestion_control.hh"
+#include "rtt_estimator.hh"
+#include "tcp_config.hh"
 #include "tcp_receiver_message.hh"
 #include "tcp_sender_message.hh"
 #include <deque>
+#include <memory>
+#include <vector>
 
 
 
 struct Timer {
   uint64_t time_passed {0};
+  bool running {false};
 
   bool is_timeout(uint64_t rto) {
     return this->time_passed >= rto;
@@ -16,21 +22,42 @@ struct Timer {
   void time_pass(uint64_t ms_since_last_tick) {
     this->time_passed += ms_since_last_tick;
   }
+  void start() {
+    this->running = true;
+    this->time_passed = 0;
+  }
+  void stop() {
+    this->running = false;
+    this->time_passed = 0;
+  }
 };
 
+struct OutstandingSegment {
+  uint64_t abs_seqno {0};   // 报文的绝对序号，避免每次比较都unwrap
+  TCPSenderMessage msg {};
+  uint64_t sent_ms {0};      // 第一次发送的时刻
+  bool retransmitted {false}; // 重传过的报文不能用来测量RTT (Karn)
+  bool sacked {false};        // 接收方已通过SACK块确认收到
 
-struct MessageInfo {
-  bool already_send {false};
+  uint64_t abs_end() const {
+    return abs_seqno + msg.sequence_length();
+  }
 };
 
 
-
+/* Split a segment into pieces of at most `mss` payload bytes, as a lower layer would a super-segment */
+std::vector<TCPSenderMessage> split_super_segment( const TCPSenderMessage& msg, size_t mss );
 
 class TCPSender
 {
 public:
-  /* Construct TCP sender with given default Retransmission Timeout and possible ISN */
-  TCPSender( uint64_t initial_RTO_ms, std::optional<Wrap32> fixed_isn );
+  /* Construct TCP sender with given default Retransmission Timeout, possible ISN and congestion control */
+  TCPSender( uint64_t initial_RTO_ms,
+             std::optional<Wrap32> fixed_isn,
+             std::unique_ptr<CongestionControl> congestion_control = nullptr );
+
+  /* Construct TCP sender from a TCPConfig (RTO, ISN, congestion control, RTT estimation and segmentation) */
+  explicit TCPSender( const TCPConfig& config );
 
   /* Push bytes from the outbound stream */
   void push( Reader& outbound_stream );
@@ -50,11 +77,23 @@ public:
   /* Accessors for use in testing */
   uint64_t sequence_numbers_in_flight() const;  // How many sequence numbers are outstanding?
   uint64_t consecutive_retransmissions() const; // How many consecutive *re*transmissions have happened?
+  const CongestionControl* congestion_control() const { return cc_.get(); } // nullptr if there is none
+
+  /* The peer's SYN carried this MSS option; send no larger payloads (at most our own configured MSS) */
+  void set_peer_mss( uint16_t peer_mss );
+
+  /* The peer's SYN carried this window-scale shift; it applies only if our SYN offered window scaling too */
+  void set_peer_window_scale( uint8_t shift );
+
+  /* Accessors for monitoring */
+  uint64_t current_RTO_ms() const { return rto_; }      // including any exponential back-off
+  std::optional<uint64_t> srtt_ms() const;              // empty until an RTT has been measured
+  uint64_t mss() const { return mss_; }                 // largest payload per segment (or super-segment piece)
 
 private:
   Wrap32 isn_;
   uint64_t initial_RTO_ms_;
-  Wrap32 ackno_;
+  uint64_t ackno_;           // 已确认的绝对序号
   uint64_t window_size_;
   uint64_t checkpoint_;
   bool syn_;
@@ -63,11 +102,41 @@ private:
   uint64_t retrans_count_;
   uint64_t rto_;
   Timer timer_;
-  std::deque<std::pair<MessageInfo, TCPSenderMessage>> outstanding_;
-
-  int compare_seqno(Wrap32 left, Wrap32 right) {
-    if (left.unwrap(isn_, checkpoint_) < right.unwrap(isn_, checkpoint_)) return -1;
-    if (left.unwrap(isn_, checkpoint_) == right.unwrap(isn_, checkpoint_)) return 0;
-    return 1;
-  }
+  // 已生成但未确认的报文，按seqno排序；[0, next_unsent_)已发送，其余待发送
+  std::deque<OutstandingSegment> outstanding_;
+  size_t next_unsent_;       // 下一个待发送报文在outstanding_中的下标
+  bool retransmit_front_;    // 超时后待重传outstanding_.front()
+  uint64_t seqnos_in_flight_;  // total sequence_length() of outstanding_
+  std::unique_ptr<CongestionControl> cc_;  // 为空时只受接收方窗口限制
+  std::optional<RTTEstimator> rtt_ {};     // 为空时RTO固定为initial_RTO_ms_
+  uint64_t now_ms_ {0};                    // tick()累计的时间
+  uint64_t dup_acks_ {0};                  // 连续收到的重复ack数
+  // SACK记分板：报文的sacked标记，加上SACK块覆盖到的最高序号
+  uint64_t highest_sacked_ {0};
+  std::optional<uint64_t> hole_cursor_ {}; // SACK恢复中，此序号之前的缺口都已重传
+  uint64_t sack_recover_ {0};              // 进入SACK恢复时的next_sent_seqno()，ack越过它时恢复结束
+  uint64_t local_mss_;                     // 本端配置的MSS，在SYN里通告
+  uint64_t path_mss_;                      // 与对端协商后的MSS
+  uint64_t mss_;                           // 当前使用的MSS，PMTU探测可能把它调小
+  uint64_t super_segment_size_ {0};        // 非0时push()按此大小生成超级报文
+  bool pmtu_probing_ {false};
+  uint64_t pmtu_interval_ms_ {TCPConfig::PMTU_PROBE_INTERVAL_DFLT};
+  uint64_t pmtu_losses_ {0};               // 满长报文连续超时的次数
+  std::optional<uint64_t> pmtu_shrunk_at_ {}; // 上次调小MSS的时刻
+  std::optional<uint8_t> wscale_offer_ {};  // SYN里通告的本端窗口缩放位移，为空时不启用窗口缩放
+  uint8_t peer_shift_ {0};                  // 对端通告的窗口要左移的位数
+  std::optional<uint64_t> nagle_timeout_ {}; // 为空时不扣留不足MSS的尾部
+  std::optional<uint64_t> nagle_since_ {};   // 开始扣留尾部的时刻
+
+  void queue_segment(TCPSenderMessage msg);
+  uint64_t next_sent_seqno() const;
+  size_t sent_index(uint64_t abs_seqno) const; // 第一个结束于abs_seqno之后的已发送报文的下标
+  void mark_sacked(const std::vector<SackBlock>& blocks);
+  OutstandingSegment* next_hole();
+  bool hold_tail(const Reader& outbound_stream);
+  uint64_t max_payload() const { return super_segment_size_ > 0 ? super_segment_size_ : mss_; }
+  void set_mss(uint64_t mss, bool reset_window);
+  void shrink_mss();
+  void resegment();
+  uint64_t sent_in_flight() const { return next_sent_seqno() - ackno_; } // 已发送未确认的序号数
 };
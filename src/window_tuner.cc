@@ -0,0 +1,46 @@
+#include "window_tuner.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+WindowTuner::WindowTuner(uint64_t min_capacity, uint64_t max_capacity, uint64_t idle_ms)
+  : min_capacity_(min_capacity)
+  , max_capacity_(max(max_capacity, min_capacity))
+  , idle_ms_(idle_ms)
+{}
+
+void WindowTuner::set_rtt(uint64_t rtt_ms)
+{
+  rtt_ms_ = max(rtt_ms, uint64_t{1});
+}
+
+uint64_t WindowTuner::tick(uint64_t ms_since_last_tick, uint64_t bytes_pushed, uint64_t bytes_popped,
+                           uint64_t buffered, uint64_t capacity)
+{
+  if (bytes_pushed != last_pushed_ || bytes_popped != last_popped_) {
+    idle_for_ms_ = 0;
+    last_pushed_ = bytes_pushed;
+    last_popped_ = bytes_popped;
+  } else {
+    idle_for_ms_ += ms_since_last_tick;
+  }
+
+  if (idle_for_ms_ >= idle_ms_) {
+    // 空闲太久：发送方反正要重新慢启动（RFC 5681 4.1），把内存还回去
+    elapsed_ms_ = 0;
+    popped_at_start_ = bytes_popped;
+    best_drain_ = 0;
+    return max(min_capacity_, buffered);
+  }
+
+  elapsed_ms_ += ms_since_last_tick;
+  if (elapsed_ms_ < rtt_ms_) return capacity;
+  // 每个RTT测一次应用读走的字节数
+  const uint64_t drained = bytes_popped - popped_at_start_;
+  elapsed_ms_ = 0;
+  popped_at_start_ = bytes_popped;
+  if (drained <= best_drain_) return capacity;
+  best_drain_ = drained;
+  return max(capacity, clamp(2 * drained, min_capacity_, max_capacity_));
+}
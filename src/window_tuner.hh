@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * WindowTuner: dynamic right-sizing of the receive buffer, in the manner of Linux's
+ * tcp_rcv_space_adjust(). Once per RTT it measures how many bytes the application drained;
+ * a sender limited only by our window can deliver at most one window per RTT, so to let it
+ * keep doubling, the buffer grows to twice the best drain seen so far,
+ *
+ *   capacity = clamp(2 * drained per RTT, min_capacity, max_capacity).
+ *
+ * Growth only: a consumer that falls behind fills the buffer and closes the window by itself.
+ * Once the stream has been idle (nothing pushed or popped) for idle_ms, the capacity drops
+ * back to min_capacity, or to what is still buffered, and the drain measurement starts over.
+ * The caller must not shrink below a window it has already advertised.
+ */
+class WindowTuner
+{
+public:
+  static constexpr uint64_t DEFAULT_RTT_MS = 200; // measurement interval until an RTT is known
+
+  WindowTuner(uint64_t min_capacity, uint64_t max_capacity, uint64_t idle_ms);
+
+  void set_rtt(uint64_t rtt_ms);
+
+  // Time has passed; given the stream's counters, return the capacity it should have from now on.
+  uint64_t tick(uint64_t ms_since_last_tick, uint64_t bytes_pushed, uint64_t bytes_popped, uint64_t buffered,
+                uint64_t capacity);
+
+  uint64_t min_capacity() const { return min_capacity_; }
+  uint64_t max_capacity() const { return max_capacity_; }
+
+private:
+  uint64_t min_capacity_;
+  uint64_t max_capacity_;
+  uint64_t idle_ms_;
+  uint64_t rtt_ms_ {DEFAULT_RTT_MS};
+  uint64_t elapsed_ms_ {0};     // time into the current measurement
+  uint64_t popped_at_start_ {0}; // bytes_popped when the current measurement began
+  uint64_t best_drain_ {0};      // most bytes drained in one RTT since the last idle period
+  uint64_t idle_for_ms_ {0};
+  uint64_t last_pushed_ {0};
+  uint64_t last_popped_ {0};
+};
@@ -97,6 +97,29 @@ int main()
       test.execute( BytesBuffered { 1 } );
     }
 
+    for ( const auto storage : { ByteStream::Storage::Ring, ByteStream::Storage::Chunked } ) {
+      ByteStreamTestHarness test { "set_capacity keeps wrapped data in order", 4, storage };
+      test.execute( Push { "abcd" } );
+      test.execute( Pop { 2 } );
+      test.execute( Push { "ef" } );
+      test.execute( SetCapacity { 8 } );
+      test.execute( Capacity { 8 } );
+      test.execute( AvailableCapacity { 4 } );
+      test.execute( Push { "ghijk" } );
+      test.execute( BytesBuffered { 8 } );
+      test.execute( ReadAll { "cdefghij" } );
+
+      // never below what is buffered
+      test.execute( Push { "lmn" } );
+      test.execute( SetCapacity { 1 } );
+      test.execute( Capacity { 3 } );
+      test.execute( AvailableCapacity { 0 } );
+      test.execute( ReadAll { "lmn" } );
+      test.execute( SetCapacity { 2 } );
+      test.execute( Push { "opq" } );
+      test.execute( ReadAll { "op" } );
+    }
+
   } catch ( const exception& e ) {
     cerr << "Exception: " << e.what() << endl;
     return EXIT_FAILURE;
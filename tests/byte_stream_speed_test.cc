@@ -15,7 +15,8 @@ void speed_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-p
                  const size_t capacity,    // NOLINT(bugprone-easily-swappable-parameters)
                  const size_t random_seed, // NOLINT(bugprone-easily-swappable-parameters)
                  const size_t write_size,  // NOLINT(bugprone-easily-swappable-parameters)
-                 const size_t read_size )  // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t read_size,   // NOLINT(bugprone-easily-swappable-parameters)
+                 const ByteStream::Storage storage = ByteStream::Storage::Ring )
 {
   // Generate the data to be written
   const string data = [&random_seed, &input_len] {
@@ -34,7 +35,7 @@ void speed_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-p
     split_data.emplace( data.substr( i, write_size ) );
   }
 
-  ByteStream bs { capacity };
+  ByteStream bs { capacity, storage };
   string output_data;
   output_data.reserve( data.size() );
 
@@ -75,10 +76,14 @@ void speed_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-p
   fstream debug_output;
   debug_output.open( "/dev/tty" );
 
-  cout << "ByteStream with capacity=" << capacity << ", write_size=" << write_size << ", read_size=" << read_size
-       << " reached " << fixed << setprecision( 2 ) << gigabits_per_second << " Gbit/s.\n";
+  const string storage_name = storage == ByteStream::Storage::Chunked ? "Chunked " : "";
 
-  debug_output << "             ByteStream throughput: " << fixed << setprecision( 2 ) << gigabits_per_second
+  cout << storage_name << "ByteStream with capacity=" << capacity << ", write_size=" << write_size
+       << ", read_size=" << read_size << " reached " << fixed << setprecision( 2 ) << gigabits_per_second
+       << " Gbit/s.\n";
+
+  debug_output << "             " << storage_name << "ByteStream throughput (write_size=" << write_size
+               << ", read_size=" << read_size << "): " << fixed << setprecision( 2 ) << gigabits_per_second
                << " Gbit/s\n";
 
   if ( gigabits_per_second < 0.1 ) {
@@ -89,6 +94,14 @@ void speed_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-p
 void program_body()
 {
   speed_test( 1e7, 32768, 789, 1500, 128 );
+  speed_test( 1e7, 32768, 789, 1500, 1500 );
+  speed_test( 1e7, 32768, 789, 128, 1500 );
+  speed_test( 1e7, 65536, 789, 1000, 65536 );
+  speed_test( 1e7, 4096, 789, 3000, 1000 );
+
+  speed_test( 1e7, 32768, 789, 1500, 128, ByteStream::Storage::Chunked );
+  speed_test( 1e7, 32768, 789, 1500, 1500, ByteStream::Storage::Chunked );
+  speed_test( 1e7, 65536, 789, 1000, 65536, ByteStream::Storage::Chunked );
 }
 
 int main()
@@ -5,11 +5,13 @@
 
 using namespace std;
 
-void stress_test( const size_t input_len,    // NOLINT(bugprone-easily-swappable-parameters)
-                  const size_t capacity,     // NOLINT(bugprone-easily-swappable-parameters)
-                  const size_t random_seed ) // NOLINT(bugprone-easily-swappable-parameters)
+void stress_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-parameters)
+                  const size_t capacity,    // NOLINT(bugprone-easily-swappable-parameters)
+                  const size_t random_seed, // NOLINT(bugprone-easily-swappable-parameters)
+                  const ByteStream::Storage storage = ByteStream::Storage::Ring )
 {
   default_random_engine rd { random_seed };
+  default_random_engine iovec_rd { random_seed + 1 }; // kept apart so rd's push/pop schedule is unchanged
 
   const string data = [&rd, &input_len] {
     uniform_int_distribution<char> ud;
@@ -20,8 +22,11 @@ void stress_test( const size_t input_len,    // NOLINT(bugprone-easily-swappable
     return ret;
   }();
 
-  ByteStreamTestHarness bs { "stress test input=" + to_string( input_len ) + ", capacity=" + to_string( capacity ),
-                             capacity };
+  const string storage_name = storage == ByteStream::Storage::Chunked ? ", chunked" : "";
+  ByteStreamTestHarness bs {
+    "stress test input=" + to_string( input_len ) + ", capacity=" + to_string( capacity ) + storage_name,
+    capacity,
+    storage };
 
   size_t expected_bytes_pushed {};
   size_t expected_bytes_popped {};
@@ -57,6 +62,10 @@ void stress_test( const size_t input_len,    // NOLINT(bugprone-easily-swappable
 
     bs.execute( PeekOnce { data.substr( expected_bytes_popped, peek_size ) } );
 
+    uniform_int_distribution<size_t> iovec_bytes_dist { 0, expected_bytes_pushed - expected_bytes_popped };
+    const size_t iovec_bytes = iovec_bytes_dist( iovec_rd );
+    bs.execute( PeekIovecs { data.substr( expected_bytes_popped, iovec_bytes ), iovec_bytes } );
+
     uniform_int_distribution<size_t> bytes_to_pop_dist { 0, peek_size };
     const size_t amount_to_pop = bytes_to_pop_dist( rd );
 
@@ -76,6 +85,10 @@ void program_body()
   stress_test( 18, 17, 12345 );
   stress_test( 1111, 17, 98765 );
   stress_test( 4097, 4096, 11101 );
+
+  stress_test( 19, 3, 10110, ByteStream::Storage::Chunked );
+  stress_test( 1111, 17, 98765, ByteStream::Storage::Chunked );
+  stress_test( 4097, 4096, 11101, ByteStream::Storage::Chunked );
 }
 
 int main()
@@ -0,0 +1,136 @@
+#include "congestion_control_test_harness.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+int main()
+{
+  try {
+    constexpr uint64_t no_ssthresh = numeric_limits<uint64_t>::max();
+    constexpr auto reno = CongestionControlAlgorithm::Reno;
+    constexpr auto newreno = CongestionControlAlgorithm::NewReno;
+
+    {
+      CongestionControlTestHarness test { "initial window follows the segment size", reno, 1000 };
+      test.execute( Cwnd { 4000 } );
+      test.execute( Ssthresh { no_ssthresh } );
+      test.execute( InSlowStart { true } );
+    }
+
+    {
+      CongestionControlTestHarness test { "initial window for large segments", reno, 1460 };
+      test.execute( Cwnd { 4380 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "initial window for jumbo segments", reno, 3000 };
+      test.execute( Cwnd { 6000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "slow start grows at most one MSS per ack", reno, 1000 };
+      test.execute( AckNewData { 1001, 1000, 4000 } );
+      test.execute( Cwnd { 5000 } );
+      test.execute( AckNewData { 1501, 500, 4000 } );
+      test.execute( Cwnd { 5500 } );
+      test.execute( AckNewData { 4501, 3000, 4500 } );
+      test.execute( Cwnd { 6500 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "timeout restarts slow start from one MSS", reno, 1000 };
+      test.execute( RetransmissionTimeout { 8000, 8001 } );
+      test.execute( Ssthresh { 4000 } );
+      test.execute( Cwnd { 1000 } );
+      test.execute( InSlowStart { true } );
+
+      test.execute( AckNewData { 1001, 1000, 8000 } );
+      test.execute( Cwnd { 2000 } );
+      test.execute( AckNewData { 2001, 1000, 7000 } );
+      test.execute( Cwnd { 3000 } );
+      test.execute( AckNewData { 3001, 1000, 6000 } );
+      test.execute( Cwnd { 4000 } );
+      test.execute( InSlowStart { false } );
+
+      // congestion avoidance: one MSS per window's worth of acked data
+      test.execute( AckNewData { 4001, 1000, 5000 } );
+      test.execute( AckNewData { 5001, 1000, 4000 } );
+      test.execute( AckNewData { 6001, 1000, 4000 } );
+      test.execute( Cwnd { 4000 } );
+      test.execute( AckNewData { 7001, 1000, 4000 } );
+      test.execute( Cwnd { 5000 } );
+      test.execute( AckNewData { 11001, 4000, 5000 } );
+      test.execute( Cwnd { 5000 } );
+      test.execute( AckNewData { 12001, 1000, 5000 } );
+      test.execute( Cwnd { 6000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "ssthresh never drops below two MSS", reno, 1000 };
+      test.execute( RetransmissionTimeout { 1000, 1001 } );
+      test.execute( Ssthresh { 2000 } );
+      test.execute( Cwnd { 1000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "Reno leaves fast recovery on the first new ack", reno, 1000 };
+      test.execute( FastRetransmit { 10000, 20001 } );
+      test.execute( InRecovery { true } );
+      test.execute( Ssthresh { 5000 } );
+      test.execute( Cwnd { 8000 } );
+      test.execute( DuplicateAck {} );
+      test.execute( Cwnd { 9000 } );
+      test.execute( AckNewData { 12001, 2000, 10000 }.with_retransmit( false ) );
+      test.execute( InRecovery { false } );
+      test.execute( Cwnd { 5000 } );
+      test.execute( DuplicateAck {} );
+      test.execute( Cwnd { 5000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "NewReno stays in recovery on partial acks", newreno, 1000 };
+      test.execute( FastRetransmit { 10000, 20001 } );
+      test.execute( DuplicateAck {} );
+      test.execute( DuplicateAck {} );
+      test.execute( Cwnd { 10000 } );
+
+      test.execute( AckNewData { 13001, 2000, 10000 }.with_retransmit( true ) );
+      test.execute( InRecovery { true } );
+      test.execute( Cwnd { 9000 } );
+
+      test.execute( AckNewData { 13501, 500, 8000 }.with_retransmit( true ) );
+      test.execute( Cwnd { 8500 } );
+
+      test.execute( AckNewData { 20001, 6500, 7500 }.with_retransmit( false ) );
+      test.execute( InRecovery { false } );
+      test.execute( Cwnd { 2000 } );
+      test.execute( Ssthresh { 5000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "NewReno full ack deflates to ssthresh", newreno, 1000 };
+      test.execute( FastRetransmit { 10000, 20001 } );
+      test.execute( AckNewData { 20001, 1000, 10000 }.with_retransmit( false ) );
+      test.execute( InRecovery { false } );
+      test.execute( Cwnd { 5000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "timeout ends fast recovery", newreno, 1000 };
+      test.execute( FastRetransmit { 10000, 20001 } );
+      test.execute( RetransmissionTimeout { 9000, 20001 } );
+      test.execute( InRecovery { false } );
+      test.execute( Ssthresh { 4500 } );
+      test.execute( Cwnd { 1000 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "common.hh"
+#include "congestion_control.hh"
+
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+struct CongestionControlUnderTest
+{
+  std::unique_ptr<CongestionControl> cc;
+  uint64_t ackno {}; // the last ackno reported to `cc`
+};
+
+/*
+ * Drives a CongestionControl policy directly with the events a TCPSender would report,
+ * so the window's evolution can be checked step by step without any wrapping, and with
+ * time passing only when a step says so.
+ */
+class CongestionControlTestHarness : public TestHarness<CongestionControlUnderTest>
+{
+public:
+  CongestionControlTestHarness( std::string test_name,
+                                CongestionControlAlgorithm algorithm,
+                                uint64_t mss,
+                                bool cubic_fast_convergence = true )
+    : TestHarness( move( test_name ),
+                   "mss=" + std::to_string( mss ),
+                   { make_congestion_control( algorithm, mss, cubic_fast_convergence ) } )
+  {}
+};
+
+struct AckNewData : public Action<CongestionControlUnderTest>
+{
+  uint64_t ackno_;
+  uint64_t acked_;
+  uint64_t in_flight_;
+  std::optional<bool> retransmit_ {};
+
+  AckNewData( uint64_t ackno, uint64_t acked, uint64_t in_flight )
+    : ackno_( ackno ), acked_( acked ), in_flight_( in_flight )
+  {}
+
+  AckNewData& with_retransmit( bool retransmit )
+  {
+    retransmit_ = retransmit;
+    return *this;
+  }
+
+  std::string description() const override
+  {
+    std::ostringstream desc;
+    desc << "ack of " << acked_ << " new seqnos up to " << ackno_ << " with " << in_flight_ << " in flight";
+    if ( retransmit_.has_value() ) {
+      desc << ( retransmit_.value() ? ", asking for a retransmission" : ", not asking for a retransmission" );
+    }
+    return desc.str();
+  }
+
+  void execute( CongestionControlUnderTest& t ) const override
+  {
+    const bool retransmit = t.cc->on_ack( ackno_, acked_, in_flight_ );
+    t.ackno = ackno_;
+    if ( retransmit_.has_value() and retransmit != retransmit_.value() ) {
+      throw ExpectationViolation( "on_ack() return value", retransmit_.value(), retransmit );
+    }
+  }
+};
+
+struct FastRetransmit : public Action<CongestionControlUnderTest>
+{
+  uint64_t in_flight_;
+  uint64_t next_seqno_;
+
+  FastRetransmit( uint64_t in_flight, uint64_t next_seqno ) : in_flight_( in_flight ), next_seqno_( next_seqno ) {}
+
+  std::string description() const override
+  {
+    return "fast retransmit with " + std::to_string( in_flight_ ) + " in flight, next seqno "
+           + std::to_string( next_seqno_ );
+  }
+
+  void execute( CongestionControlUnderTest& t ) const override
+  {
+    t.cc->on_fast_retransmit( in_flight_, next_seqno_ );
+  }
+};
+
+struct DuplicateAck : public Action<CongestionControlUnderTest>
+{
+  std::string description() const override { return "duplicate ack"; }
+  void execute( CongestionControlUnderTest& t ) const override { t.cc->on_duplicate_ack(); }
+};
+
+struct RetransmissionTimeout : public Action<CongestionControlUnderTest>
+{
+  uint64_t in_flight_;
+  uint64_t next_seqno_;
+  bool repeated_ = false;
+
+  RetransmissionTimeout( uint64_t in_flight, uint64_t next_seqno )
+    : in_flight_( in_flight ), next_seqno_( next_seqno )
+  {}
+
+  // the same segment timed out again
+  RetransmissionTimeout& repeated()
+  {
+    repeated_ = true;
+    return *this;
+  }
+
+  std::string description() const override
+  {
+    return std::string( repeated_ ? "repeated " : "" ) + "retransmission timeout with "
+           + std::to_string( in_flight_ ) + " in flight";
+  }
+
+  void execute( CongestionControlUnderTest& t ) const override
+  {
+    t.cc->on_timeout( in_flight_, next_seqno_, repeated_ );
+  }
+};
+
+struct Elapse : public Action<CongestionControlUnderTest>
+{
+  uint64_t ms_;
+
+  explicit Elapse( uint64_t ms ) : ms_( ms ) {}
+  std::string description() const override { return std::to_string( ms_ ) + " ms pass"; }
+  void execute( CongestionControlUnderTest& t ) const override { t.cc->on_tick( ms_ ); }
+};
+
+// Replays `rounds` loss-free round trips: each one lasts `rtt_ms`, then the whole window is
+// acknowledged one MSS at a time.
+struct AckRounds : public Action<CongestionControlUnderTest>
+{
+  uint64_t rounds_;
+  uint64_t rtt_ms_;
+
+  AckRounds( uint64_t rounds, uint64_t rtt_ms ) : rounds_( rounds ), rtt_ms_( rtt_ms ) {}
+
+  std::string description() const override
+  {
+    return std::to_string( rounds_ ) + " round trips of " + std::to_string( rtt_ms_ )
+           + " ms with every segment acked";
+  }
+
+  void execute( CongestionControlUnderTest& t ) const override
+  {
+    const uint64_t mss = t.cc->mss();
+    for ( uint64_t round = 0; round < rounds_; ++round ) {
+      t.cc->on_tick( rtt_ms_ );
+      for ( uint64_t in_flight = t.cc->cwnd(); in_flight >= mss; in_flight -= mss ) {
+        t.ackno += mss;
+        t.cc->on_ack( t.ackno, mss, in_flight );
+      }
+    }
+  }
+};
+
+struct CwndBetween : public Expectation<CongestionControlUnderTest>
+{
+  uint64_t low_;
+  uint64_t high_;
+
+  CwndBetween( uint64_t low, uint64_t high ) : low_( low ), high_( high ) {}
+
+  std::string description() const override
+  {
+    return "cwnd between " + std::to_string( low_ ) + " and " + std::to_string( high_ );
+  }
+
+  void execute( CongestionControlUnderTest& t ) const override
+  {
+    const uint64_t cwnd = t.cc->cwnd();
+    if ( cwnd < low_ or cwnd > high_ ) {
+      throw ExpectationViolation( "cwnd was " + std::to_string( cwnd ) + ", outside [" + std::to_string( low_ )
+                                  + ", " + std::to_string( high_ ) + "]" );
+    }
+  }
+};
+
+struct WMax : public ExpectNumber<CongestionControlUnderTest, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "w_max"; }
+  uint64_t value( CongestionControlUnderTest& t ) const override
+  {
+    const auto* cubic = dynamic_cast<const CubicCongestionControl*>( t.cc.get() );
+    if ( cubic == nullptr ) {
+      throw std::runtime_error( "inconsistent test: w_max is only defined for CUBIC" );
+    }
+    return cubic->w_max();
+  }
+};
+
+struct Cwnd : public ExpectNumber<CongestionControlUnderTest, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "cwnd"; }
+  uint64_t value( CongestionControlUnderTest& t ) const override { return t.cc->cwnd(); }
+};
+
+struct Ssthresh : public ExpectNumber<CongestionControlUnderTest, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "ssthresh"; }
+  uint64_t value( CongestionControlUnderTest& t ) const override { return t.cc->ssthresh(); }
+};
+
+struct InSlowStart : public ExpectBool<CongestionControlUnderTest>
+{
+  using ExpectBool::ExpectBool;
+  std::string name() const override { return "in_slow_start"; }
+  bool value( CongestionControlUnderTest& t ) const override { return t.cc->in_slow_start(); }
+};
+
+struct InRecovery : public ExpectBool<CongestionControlUnderTest>
+{
+  using ExpectBool::ExpectBool;
+  std::string name() const override { return "in_recovery"; }
+  bool value( CongestionControlUnderTest& t ) const override { return t.cc->in_recovery(); }
+};
@@ -0,0 +1,145 @@
+#include "congestion_control_test_harness.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+// Slow start from the initial 4 MSS window up to 100 segments, then lose one segment and
+// finish fast recovery, leaving the window at ssthresh.
+void grow_to_100_segments_then_lose_one( CongestionControlTestHarness& test, uint64_t ssthresh )
+{
+  for ( uint64_t ackno = 1000; ackno <= 96000; ackno += 1000 ) {
+    test.execute( AckNewData { ackno, 1000, 4000 } );
+  }
+  test.execute( Cwnd { 100000 } );
+  test.execute( FastRetransmit { 100000, 196001 } );
+  test.execute( Ssthresh { ssthresh } );
+  test.execute( AckNewData { 196001, 1000, 100000 }.with_retransmit( false ) );
+  test.execute( InRecovery { false } );
+  test.execute( Cwnd { ssthresh } );
+}
+} // namespace
+
+int main()
+{
+  try {
+    constexpr auto cubic = CongestionControlAlgorithm::Cubic;
+    constexpr auto newreno = CongestionControlAlgorithm::NewReno;
+
+    {
+      CongestionControlTestHarness test { "CUBIC cuts the window by beta on loss", cubic, 1000 };
+      grow_to_100_segments_then_lose_one( test, 70000 );
+      test.execute( WMax { 100000 } );
+    }
+
+    {
+      // 400 ms round trips, as on the long-haul path: K = cbrt(100 * 0.3 / 0.4) = 4.2 s
+      CongestionControlTestHarness test { "CUBIC window curve after a loss at 400 ms RTT", cubic, 1000 };
+      grow_to_100_segments_then_lose_one( test, 70000 );
+
+      // concave: most of the gap back to W_max is closed within half of K
+      test.execute( AckRounds { 5, 400 } );
+      test.execute( CwndBetween { 87000, 93000 } );
+
+      // plateau: the window flattens out just under W_max around K
+      test.execute( AckRounds { 6, 400 } );
+      test.execute( CwndBetween { 98500, 100000 } );
+      test.execute( AckRounds { 2, 400 } );
+      test.execute( CwndBetween { 99500, 100500 } );
+
+      // convex: then it probes past W_max, faster and faster
+      test.execute( AckRounds { 6, 400 } );
+      test.execute( CwndBetween { 105000, 112000 } );
+      test.execute( AckRounds { 6, 400 } );
+      test.execute( CwndBetween { 130000, 160000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "NewReno on the same trace recovers linearly", newreno, 1000 };
+      grow_to_100_segments_then_lose_one( test, 50000 );
+      test.execute( AckRounds { 11, 400 } );
+      test.execute( CwndBetween { 60000, 62000 } );
+    }
+
+    {
+      // W_max = 10, K = 2 s, but 10 ms round trips: the cubic curve would barely move
+      CongestionControlTestHarness test { "CUBIC grows at least as fast as Reno on short paths", cubic, 1000 };
+      for ( uint64_t ackno = 1000; ackno <= 6000; ackno += 1000 ) {
+        test.execute( AckNewData { ackno, 1000, 4000 } );
+      }
+      test.execute( FastRetransmit { 10000, 10001 } );
+      test.execute( AckNewData { 10001, 1000, 10000 } );
+      test.execute( Cwnd { 7000 } );
+      test.execute( WMax { 10000 } );
+
+      // about 3 * (1 - beta) / (1 + beta) = 0.53 segments per round trip
+      test.execute( AckRounds { 10, 10 } );
+      test.execute( CwndBetween { 11500, 12500 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "fast convergence lowers W_max after an early loss", cubic, 1000 };
+      grow_to_100_segments_then_lose_one( test, 70000 );
+      test.execute( FastRetransmit { 70000, 266001 } );
+      test.execute( WMax { 59500 } );
+      test.execute( Ssthresh { 49000 } );
+      test.execute( Cwnd { 52000 } );
+    }
+
+    {
+      CongestionControlTestHarness test {
+        "without fast convergence W_max is the window at loss", cubic, 1000, false };
+      grow_to_100_segments_then_lose_one( test, 70000 );
+      test.execute( FastRetransmit { 70000, 266001 } );
+      test.execute( WMax { 70000 } );
+      test.execute( Ssthresh { 49000 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "CUBIC timeout restarts slow start below the curve", cubic, 1000 };
+      for ( uint64_t ackno = 1000; ackno <= 96000; ackno += 1000 ) {
+        test.execute( AckNewData { ackno, 1000, 4000 } );
+      }
+      test.execute( RetransmissionTimeout { 100000, 100001 } );
+      test.execute( Cwnd { 1000 } );
+      test.execute( Ssthresh { 70000 } );
+      test.execute( WMax { 100000 } );
+      test.execute( InSlowStart { true } );
+
+      // slow start doubles the window each round trip until it reaches ssthresh
+      test.execute( AckRounds { 6, 400 } );
+      test.execute( Cwnd { 64000 } );
+      test.execute( AckRounds { 1, 400 } );
+      test.execute( InSlowStart { false } );
+      test.execute( CwndBetween { 70000, 72000 } );
+
+      // then the cubic curve takes over toward W_max
+      test.execute( AckRounds { 10, 400 } );
+      test.execute( CwndBetween { 98000, 100500 } );
+    }
+
+    {
+      CongestionControlTestHarness test { "CUBIC keeps ssthresh and W_max when the same segment times out again",
+                                          cubic,
+                                          1000 };
+      for ( uint64_t ackno = 1000; ackno <= 96000; ackno += 1000 ) {
+        test.execute( AckNewData { ackno, 1000, 4000 } );
+      }
+      test.execute( RetransmissionTimeout { 100000, 100001 } );
+      test.execute( Ssthresh { 70000 } );
+      test.execute( WMax { 100000 } );
+      test.execute( RetransmissionTimeout { 100000, 100001 }.repeated() );
+      test.execute( Cwnd { 1000 } );
+      test.execute( Ssthresh { 70000 } );
+      test.execute( WMax { 100000 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
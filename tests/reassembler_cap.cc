@@ -97,6 +97,29 @@ int main()
       test.execute( ReadAll( "c" ) );
     }
 
+#ifndef MINNOW_BITMAP_REASSEMBLER // the bitmap backend sizes its ring to the window instead
+    {
+      ReassemblerTestHarness test { "memory is proportional to stored bytes", 65536 };
+
+      test.execute( Insert { string( 1000, 'a' ), 0 } );
+      test.execute( BytesPending( 0 ) );
+      test.execute( MemoryUsageAtMost( 0 ) );
+
+      test.execute( Insert { string( 500, 'c' ), 2000 } );
+      test.execute( BytesPending( 500 ) );
+      test.execute( MemoryUsageAtMost( 1000 ) );
+
+      test.execute( Insert { string( 50000, 'd' ), 2500 } );
+      test.execute( BytesPending( 50500 ) );
+      test.execute( MemoryUsageAtMost( 2 * 50500 ) );
+
+      test.execute( Insert { string( 1000, 'b' ), 1000 } );
+      test.execute( BytesPushed( 52500 ) );
+      test.execute( BytesPending( 0 ) );
+      test.execute( MemoryUsageAtMost( 0 ) );
+    }
+#endif
+
   } catch ( const exception& e ) {
     cerr << "Exception: " << e.what() << endl;
     return EXIT_FAILURE;
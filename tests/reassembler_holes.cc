@@ -2,6 +2,7 @@
 
 #include <exception>
 #include <iostream>
+#include <string>
 
 using namespace std;
 
@@ -129,6 +130,22 @@ int main()
       test.execute( ReadAll( "" ) );
       test.execute( IsFinished { true } );
     }
+
+    {
+      // a stored run spanning many bitmap words (and the bitmap backend's 256-bit scan)
+      ReassemblerTestHarness test { "holes long run", 65000 };
+      const string run( 3000, 'x' );
+
+      test.execute( Insert { run, 1 } );
+      test.execute( Insert { "z", 3100 } );
+      test.execute( BytesPushed( 0 ) );
+      test.execute( BytesPending( 3001 ) );
+
+      test.execute( Insert { "a", 0 } );
+      test.execute( BytesPushed( 3001 ) );
+      test.execute( BytesPending( 1 ) );
+      test.execute( ReadAll( "a" + run ) );
+    }
   } catch ( const exception& e ) {
     cerr << "Exception: " << e.what() << endl;
     return EXIT_FAILURE;
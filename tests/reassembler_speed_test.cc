@@ -1,4 +1,5 @@
 #include "reassembler.hh"
+#include "tcp_config.hh"
 
 #include <algorithm>
 #include <chrono>
@@ -13,6 +14,12 @@
 using namespace std;
 using namespace std::chrono;
 
+#ifdef MINNOW_BITMAP_REASSEMBLER
+constexpr string_view backend_name = "Bitmap ";
+#else
+constexpr string_view backend_name;
+#endif
+
 void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-parameters)
                  const size_t capacity,     // NOLINT(bugprone-easily-swappable-parameters)
                  const size_t random_seed ) // NOLINT(bugprone-easily-swappable-parameters)
@@ -72,10 +79,10 @@ void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-
   fstream debug_output;
   debug_output.open( "/dev/tty" );
 
-  cout << "Reassembler to ByteStream with capacity=" << capacity << " reached " << fixed << setprecision( 2 )
+  cout << backend_name << "Reassembler to ByteStream with capacity=" << capacity << " reached " << fixed << setprecision( 2 )
        << gigabits_per_second << " Gbit/s.\n";
 
-  debug_output << "             Reassembler throughput: " << fixed << setprecision( 2 ) << gigabits_per_second
+  debug_output << "             " << backend_name << "Reassembler throughput: " << fixed << setprecision( 2 ) << gigabits_per_second
                << " Gbit/s\n";
 
   if ( gigabits_per_second < 0.1 ) {
@@ -83,9 +90,87 @@ void speed_test( const size_t num_chunks,   // NOLINT(bugprone-easily-swappable-
   }
 }
 
+void in_order_speed_test( const size_t num_chunks,  // NOLINT(bugprone-easily-swappable-parameters)
+                          const size_t chunk_size,  // NOLINT(bugprone-easily-swappable-parameters)
+                          const size_t random_seed, // NOLINT(bugprone-easily-swappable-parameters)
+                          const ByteStream::Storage storage )
+{
+  // Generate the data to be written
+  const string data = [&] {
+    default_random_engine rd { random_seed };
+    uniform_int_distribution<char> ud;
+    string ret;
+    for ( size_t i = 0; i < num_chunks * chunk_size; ++i ) {
+      ret += ud( rd );
+    }
+    return ret;
+  }();
+
+  // Split the data into in-order segments
+  queue<string> split_data;
+  for ( size_t i = 0; i < data.size(); i += chunk_size ) {
+    split_data.emplace( data.substr( i, chunk_size ) );
+  }
+
+  ByteStream stream { TCPConfig::DEFAULT_CAPACITY, storage };
+  Reassembler reassembler;
+
+  string output_data;
+  output_data.reserve( data.size() );
+
+  const auto start_time = steady_clock::now();
+  uint64_t next_index = 0;
+  while ( not split_data.empty() ) {
+    const size_t len = split_data.front().size();
+    reassembler.insert( next_index, move( split_data.front() ), split_data.size() == 1, stream.writer() );
+    split_data.pop();
+    next_index += len;
+
+    while ( stream.reader().bytes_buffered() ) {
+      const auto peeked = stream.reader().peek();
+      output_data += peeked;
+      stream.reader().pop( peeked.size() );
+    }
+  }
+
+  const auto stop_time = steady_clock::now();
+
+  if ( not stream.reader().is_finished() ) {
+    throw runtime_error( "Reassembler did not close ByteStream when finished" );
+  }
+
+  if ( data != output_data ) {
+    throw runtime_error( "Mismatch between data written and read" );
+  }
+
+  auto test_duration = duration_cast<duration<double>>( stop_time - start_time );
+  auto bytes_per_second = static_cast<double>( data.size() ) / test_duration.count();
+  auto gigabits_per_second = 8 * bytes_per_second / 1e9;
+
+  fstream debug_output;
+  debug_output.open( "/dev/tty" );
+
+  const string storage_name = storage == ByteStream::Storage::Chunked ? "chunked " : "";
+
+  cout << backend_name << "Reassembler with in-order " << chunk_size << "-byte segments to " << storage_name
+       << "ByteStream reached " << fixed << setprecision( 2 ) << bytes_per_second / 1e6 << " MB/s ("
+       << gigabits_per_second << " Gbit/s).\n";
+
+  debug_output << "             " << backend_name << "Reassembler in-order throughput (" << storage_name << "ByteStream): " << fixed
+               << setprecision( 2 ) << gigabits_per_second << " Gbit/s\n";
+
+  if ( gigabits_per_second < 0.1 ) {
+    throw runtime_error( "Reassembler did not meet minimum speed of 0.1 Gbit/s." );
+  }
+}
+
 void program_body()
 {
   speed_test( 10000, 1500, 1370 );
+  speed_test( 200, 64000, 1370 );
+
+  in_order_speed_test( 10000, 1000, 1370, ByteStream::Storage::Ring );
+  in_order_speed_test( 10000, 1000, 1370, ByteStream::Storage::Chunked );
 }
 
 int main()
@@ -0,0 +1,84 @@
+#include "reassembler_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+  try {
+    {
+      ReassemblerTestHarness test { "in-order substrings are all accepted", 8 };
+
+      test.execute( Insert { "abcd", 0 } );
+      test.execute( Insert { "efgh", 4 } );
+      test.execute( ReadAll( "abcdefgh" ) );
+      test.execute( BytesAccepted( 8 ) );
+      test.execute( DuplicateBytes( 0 ) );
+      test.execute( OutOfWindowBytes( 0 ) );
+      test.execute( LateSegments( 0 ) );
+      test.execute( MaxHoles( 0 ) );
+      test.execute( PeakPending( 0 ) );
+    }
+
+    {
+      ReassemblerTestHarness test { "retransmissions count as duplicates", 8 };
+
+      test.execute( Insert { "abcd", 0 } );
+      test.execute( Insert { "abcd", 0 } );
+      test.execute( LateSegments( 1 ) );
+      test.execute( DuplicateBytes( 4 ) );
+
+      test.execute( Insert { "cdef", 2 } );
+      test.execute( BytesPushed( 6 ) );
+      test.execute( BytesAccepted( 6 ) );
+      test.execute( DuplicateBytes( 6 ) );
+      test.execute( LateSegments( 1 ) );
+    }
+
+    {
+      ReassemblerTestHarness test { "bytes beyond capacity are out of window", 4 };
+
+      test.execute( Insert { "abcdef", 0 } );
+      test.execute( BytesPushed( 4 ) );
+      test.execute( BytesAccepted( 4 ) );
+      test.execute( OutOfWindowBytes( 2 ) );
+
+      test.execute( Insert { "gh", 6 } );
+      test.execute( OutOfWindowBytes( 4 ) );
+      test.execute( BytesAccepted( 4 ) );
+    }
+
+    {
+      ReassemblerTestHarness test { "holes and pending bytes peak while out of order", 16 };
+
+      test.execute( Insert { "b", 1 } );
+      test.execute( Insert { "d", 3 } );
+      test.execute( Insert { "fg", 5 } );
+      test.execute( BytesPending( 4 ) );
+      test.execute( MaxHoles( 3 ) );
+      test.execute( PeakPending( 4 ) );
+
+      test.execute( Insert { "cd", 2 } );
+      test.execute( BytesPending( 5 ) );
+      test.execute( DuplicateBytes( 1 ) );
+      test.execute( MaxHoles( 3 ) );
+
+      test.execute( Insert { "a", 0 } );
+      test.execute( BytesPushed( 4 ) );
+      test.execute( Insert { "e", 4 } );
+      test.execute( BytesPushed( 7 ) );
+      test.execute( BytesPending( 0 ) );
+      test.execute( BytesAccepted( 7 ) );
+      test.execute( MaxHoles( 3 ) );
+      test.execute( PeakPending( 5 ) );
+    }
+
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
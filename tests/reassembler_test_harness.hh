@@ -50,6 +50,65 @@ struct BytesPending : public ExpectNumber<StreamAndReassembler, uint64_t>
   uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.bytes_pending(); }
 };
 
+struct BytesAccepted : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().bytes_accepted"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().bytes_accepted; }
+};
+
+struct DuplicateBytes : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().duplicate_bytes"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().duplicate_bytes; }
+};
+
+struct OutOfWindowBytes : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().out_of_window_bytes"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().out_of_window_bytes; }
+};
+
+struct LateSegments : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().late_segments"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().late_segments; }
+};
+
+struct MaxHoles : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().max_holes"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().max_holes; }
+};
+
+struct PeakPending : public ExpectNumber<StreamAndReassembler, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "stats().peak_pending"; }
+  uint64_t value( StreamAndReassembler& sr ) const override { return sr.second.stats().peak_pending; }
+};
+
+struct MemoryUsageAtMost : public Expectation<StreamAndReassembler>
+{
+  uint64_t max_;
+
+  explicit MemoryUsageAtMost( uint64_t max ) : max_( max ) {}
+  std::string description() const override { return "memory_usage <= " + std::to_string( max_ ); }
+  void execute( StreamAndReassembler& sr ) const override
+  {
+    const uint64_t usage = sr.second.memory_usage();
+    if ( usage > max_ ) {
+      throw ExpectationViolation { "The Reassembler used " + std::to_string( usage )
+                                   + " bytes of memory, but should have used at most " + std::to_string( max_ )
+                                   + "." };
+    }
+  }
+};
+
 struct Insert : public Action<StreamAndReassembler>
 {
   std::string data_;
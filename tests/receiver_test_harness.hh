@@ -8,6 +8,7 @@
 #include <optional>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 using ReceiverSet = std::pair<StreamAndReassembler, TCPReceiver>;
 
@@ -34,6 +35,12 @@ public:
                    { { ByteStream { capacity }, Reassembler {} }, TCPReceiver {} } )
   {}
 
+  TCPReceiverTestHarness( std::string test_name, const TCPConfig& config )
+    : TestHarness( move( test_name ),
+                   "capacity=" + std::to_string( config.recv_capacity ),
+                   { { ByteStream { config.recv_capacity }, Reassembler {} }, TCPReceiver { config } } )
+  {}
+
   template<std::derived_from<TestStep<StreamAndReassembler>> T>
   void execute( const T& test )
   {
@@ -56,6 +63,184 @@ struct ExpectWindow : public ExpectNumber<ReceiverSet, uint16_t>
   uint16_t value( ReceiverSet& rs ) const override { return rs.second.send( rs.first.first.writer() ).window_size; }
 };
 
+struct ExpectScaledWindow : public ExpectNumber<ReceiverSet, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "window_size << window_shift()"; }
+  uint64_t value( ReceiverSet& rs ) const override
+  {
+    return uint64_t { rs.second.send( rs.first.first.writer() ).window_size } << rs.second.window_shift();
+  }
+};
+
+struct OfferWindowScale : public Action<ReceiverSet>
+{
+  uint8_t shift_;
+
+  explicit OfferWindowScale( uint8_t shift ) : shift_( shift ) {}
+  std::string description() const override { return "our SYN offers window scale " + std::to_string( shift_ ); }
+  void execute( ReceiverSet& rs ) const override { rs.second.set_window_scale( shift_ ); }
+};
+
+struct DelayAcks : public Action<ReceiverSet>
+{
+  uint64_t timeout_ms_;
+  uint16_t mss_;
+
+  DelayAcks( uint64_t timeout_ms, uint16_t mss ) : timeout_ms_( timeout_ms ), mss_( mss ) {}
+  std::string description() const override
+  {
+    return "delay acks by up to " + std::to_string( timeout_ms_ ) + " ms, mss=" + std::to_string( mss_ );
+  }
+  void execute( ReceiverSet& rs ) const override { rs.second.set_delayed_ack( timeout_ms_, mss_ ); }
+};
+
+struct Tick : public Action<ReceiverSet>
+{
+  uint64_t ms_;
+
+  explicit Tick( uint64_t ms ) : ms_( ms ) {}
+  std::string description() const override { return std::to_string( ms_ ) + " ms pass"; }
+  void execute( ReceiverSet& rs ) const override
+  {
+    rs.second.tick( ms_, rs.first.second, rs.first.first.writer() );
+  }
+};
+
+struct AutoTune : public Action<ReceiverSet>
+{
+  uint64_t min_capacity_;
+  uint64_t max_capacity_;
+  uint64_t idle_ms_;
+
+  AutoTune( uint64_t min_capacity, uint64_t max_capacity, uint64_t idle_ms ) // NOLINT(*-swappable-*)
+    : min_capacity_( min_capacity ), max_capacity_( max_capacity ), idle_ms_( idle_ms )
+  {}
+  std::string description() const override
+  {
+    return "auto-tune capacity within [" + std::to_string( min_capacity_ ) + ", " + std::to_string( max_capacity_ )
+           + "], idle after " + std::to_string( idle_ms_ ) + " ms";
+  }
+  void execute( ReceiverSet& rs ) const override
+  {
+    rs.second.set_autotuning( min_capacity_, max_capacity_, idle_ms_ );
+  }
+};
+
+struct SetRTT : public Action<ReceiverSet>
+{
+  uint64_t rtt_ms_;
+
+  explicit SetRTT( uint64_t rtt_ms ) : rtt_ms_( rtt_ms ) {}
+  std::string description() const override { return "RTT is " + std::to_string( rtt_ms_ ) + " ms"; }
+  void execute( ReceiverSet& rs ) const override { rs.second.set_rtt( rtt_ms_ ); }
+};
+
+struct ExpectCapacity : public ExpectNumber<ReceiverSet, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "capacity"; }
+  uint64_t value( ReceiverSet& rs ) const override { return rs.first.first.writer().capacity(); }
+};
+
+struct ExpectAck : public Expectation<ReceiverSet>
+{
+  std::optional<Wrap32> ackno_ {};
+  std::optional<uint16_t> window_size_ {};
+
+  ExpectAck& with_ackno( Wrap32 ackno )
+  {
+    ackno_ = ackno;
+    return *this;
+  }
+
+  ExpectAck& with_window( uint16_t window_size )
+  {
+    window_size_ = window_size;
+    return *this;
+  }
+
+  std::string description() const override
+  {
+    std::string ret = "ack due";
+    if ( ackno_.has_value() ) {
+      ret += " with ackno " + to_string( ackno_.value() );
+    }
+    if ( window_size_.has_value() ) {
+      ret += " with window_size " + std::to_string( window_size_.value() );
+    }
+    return ret;
+  }
+
+  void execute( ReceiverSet& rs ) const override
+  {
+    const auto ack = rs.second.maybe_send( rs.first.first.writer() );
+    if ( not ack.has_value() ) {
+      throw ExpectationViolation( "TCPReceiver should have had an ack due, but maybe_send() returned nothing." );
+    }
+    if ( ackno_.has_value() and ack->ackno != ackno_ ) {
+      throw ExpectationViolation( "ackno", ackno_, ack->ackno );
+    }
+    if ( window_size_.has_value() and ack->window_size != window_size_.value() ) {
+      throw ExpectationViolation( "window_size", window_size_.value(), ack->window_size );
+    }
+  }
+};
+
+struct ExpectNoAck : public Expectation<ReceiverSet>
+{
+  std::string description() const override { return "no ack due"; }
+  void execute( ReceiverSet& rs ) const override
+  {
+    if ( rs.second.maybe_send( rs.first.first.writer() ).has_value() ) {
+      throw ExpectationViolation( "TCPReceiver had an ack due when none was expected." );
+    }
+  }
+};
+
+/* Stream `bytes` of in-order data in `segment_size` pieces, reading each one, and count the acks due. */
+struct ExpectAcksPerByte : public Expectation<ReceiverSet>
+{
+  uint64_t bytes_;
+  uint64_t segment_size_;
+  uint64_t acks_;
+
+  ExpectAcksPerByte( uint64_t bytes, uint64_t segment_size, uint64_t acks ) // NOLINT(*-swappable-*)
+    : bytes_( bytes ), segment_size_( segment_size ), acks_( acks )
+  {}
+
+  std::string description() const override
+  {
+    return std::to_string( bytes_ ) + " bytes in " + std::to_string( segment_size_ ) + "-byte segments draw "
+           + std::to_string( acks_ ) + " acks";
+  }
+
+  void execute( ReceiverSet& rs ) const override
+  {
+    auto& [stream, reassembler] = rs.first;
+    const std::string data( segment_size_, 'x' );
+    uint64_t acks = 0;
+    for ( uint64_t sent = 0; sent < bytes_; sent += segment_size_ ) {
+      const auto ackno = rs.second.send( stream.writer() ).ackno;
+      if ( not ackno.has_value() ) {
+        throw ExpectationViolation( "TCPReceiver did not have ackno when expected" );
+      }
+      TCPSenderMessage msg;
+      msg.seqno = ackno.value();
+      msg.payload = data;
+      rs.second.receive( std::move( msg ), reassembler, stream.writer() );
+      stream.reader().pop( stream.reader().bytes_buffered() );
+      acks += rs.second.maybe_send( stream.writer() ).has_value();
+    }
+    if ( acks != acks_ ) {
+      std::ostringstream ss;
+      ss << "The TCPReceiver had " << acks << " acks due (" << static_cast<double>( acks ) / bytes_
+         << " per byte), but " << acks_ << " were expected.";
+      throw ExpectationViolation( ss.str() );
+    }
+  }
+};
+
 struct ExpectAckno : public ExpectNumber<ReceiverSet, std::optional<Wrap32>>
 {
   using ExpectNumber::ExpectNumber;
@@ -94,6 +279,39 @@ struct ExpectAcknoBetween : public Expectation<ReceiverSet>
   }
 };
 
+struct ExpectSack : public Expectation<ReceiverSet>
+{
+  std::vector<SackBlock> blocks_;
+  explicit ExpectSack( std::vector<SackBlock> blocks ) : blocks_( std::move( blocks ) ) {}
+
+  static std::string str( const std::vector<SackBlock>& blocks )
+  {
+    std::string ret = "[";
+    for ( const auto& block : blocks ) {
+      ret += " " + to_string( block.begin ) + "-" + to_string( block.end );
+    }
+    return ret + " ]";
+  }
+
+  std::string description() const override { return "SACK blocks = " + str( blocks_ ); }
+
+  void execute( ReceiverSet& rs ) const override
+  {
+    const auto sack = rs.second.send( rs.first.first.writer() ).sack;
+    if ( sack != blocks_ ) {
+      throw ExpectationViolation( "The TCPReceiver should have reported SACK blocks " + str( blocks_ )
+                                  + ", but instead it reported " + str( sack ) + "." );
+    }
+  }
+};
+
+struct ExpectPeerMSS : public ExpectNumber<ReceiverSet, std::optional<uint16_t>>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "peer_mss"; }
+  std::optional<uint16_t> value( ReceiverSet& rs ) const override { return rs.second.peer_mss(); }
+};
+
 struct HasAckno : public ExpectBool<ReceiverSet>
 {
   using ExpectBool::ExpectBool;
@@ -129,6 +347,18 @@ struct SegmentArrives : public Action<ReceiverSet>
 
   SegmentArrives& with_seqno( uint32_t seqno_ ) { return with_seqno( Wrap32 { seqno_ } ); }
 
+  SegmentArrives& with_mss( uint16_t mss )
+  {
+    msg_.mss = mss;
+    return *this;
+  }
+
+  SegmentArrives& with_window_scale( uint8_t shift )
+  {
+    msg_.window_scale = shift;
+    return *this;
+  }
+
   SegmentArrives& with_data( std::string data )
   {
     msg_.payload = move( data );
@@ -155,6 +385,12 @@ struct SegmentArrives : public Action<ReceiverSet>
     if ( msg_.SYN ) {
       ss << " +SYN";
     }
+    if ( msg_.mss.has_value() ) {
+      ss << " mss=" << msg_.mss.value();
+    }
+    if ( msg_.window_scale.has_value() ) {
+      ss << " window_scale=" << static_cast<unsigned>( msg_.window_scale.value() );
+    }
     if ( not msg_.payload.empty() ) {
       ss << " payload=\"" << Printer::prettify( msg_.payload ) << "\"";
     }
@@ -0,0 +1,161 @@
+#include "random.hh"
+#include "receiver_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "without auto-tuning the capacity is fixed", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 4000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 4000 } );
+      test.execute( Tick { 5000 } );
+      test.execute( ExpectCapacity { 4000 } );
+      test.execute( ExpectWindow { 4000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "a fast consumer doubles the window each RTT", 4000 };
+      test.execute( AutoTune { 4000, 20000, 1000 } );
+      test.execute( SetRTT { 100 } );
+      test.execute( Tick { 5000 } );
+      test.execute( ExpectCapacity { 4000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 4000 } );
+      test.execute( Tick { 99 } );
+      test.execute( ExpectWindow { 4000 } );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectCapacity { 8000 } );
+      test.execute( ExpectWindow { 8000 } );
+
+      test.execute( SegmentArrives {}.with_seqno( isn + 4001 ).with_data( string( 8000, 'x' ) ) );
+      test.execute( Pop { 8000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectWindow { 16000 } );
+
+      // held at the ceiling
+      test.execute( SegmentArrives {}.with_seqno( isn + 12001 ).with_data( string( 16000, 'x' ) ) );
+      test.execute( Pop { 16000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 20000 } );
+      test.execute( ExpectWindow { 20000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "a slow consumer does not grow the window", 4000 };
+      test.execute( AutoTune { 4000, 1 << 20, 1000 } );
+      test.execute( SetRTT { 100 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 1000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 4000 } );
+      test.execute( ExpectWindow { 1000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "an idle connection gives its memory back", 4000 };
+      test.execute( AutoTune { 4000, 1 << 20, 1000 } );
+      test.execute( SetRTT { 100 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 4000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 8000 } );
+
+      // the grown window was never advertised, so it can be given back
+      test.execute( Tick { 999 } );
+      test.execute( ExpectCapacity { 8000 } );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectCapacity { 4000 } );
+      test.execute( ExpectWindow { 4000 } );
+
+      // the drain rate is learned again from scratch
+      test.execute( SegmentArrives {}.with_seqno( isn + 4001 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 4000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 8000 } );
+
+      // out-of-order data holds the capacity where it is
+      test.execute( SegmentArrives {}.with_seqno( isn + 8001 ).with_data( string( 6000, 'x' ) ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 15001 ).with_data( "y" ) );
+      test.execute( Tick { 1000 } );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectCapacity { 8000 } );
+
+      // unread data is kept, and an advertised window is never taken back
+      test.execute( SegmentArrives {}.with_seqno( isn + 14001 ).with_data( string( 1000, 'x' ) ) );
+      test.execute( ExpectWindow { 999 } );
+      test.execute( Tick { 1000 } );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectCapacity { 8000 } );
+      test.execute( ExpectWindow { 999 } );
+      test.execute( Pop { 7001 } );
+      test.execute( Tick { 1000 } );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectCapacity { 4000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPConfig cfg;
+      cfg.recv_capacity = 4000;
+      cfg.recv_autotuning = true;
+      cfg.recv_capacity_min = 4000;
+      cfg.recv_capacity_max = 20000;
+      cfg.recv_idle_ms = 1000;
+
+      TCPReceiverTestHarness test { "auto-tuning configured through TCPConfig", cfg };
+      test.execute( SetRTT { 100 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 4000, 'x' ) ) );
+      test.execute( Pop { 4000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 8000 } );
+      test.execute( ExpectWindow { 8000 } );
+
+      // idle, but the 8000-byte window is already promised
+      test.execute( Tick { 1000 } );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectCapacity { 8000 } );
+      test.execute( ExpectWindow { 8000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "with window scaling the tuned window passes 64 KB", 64000 };
+      test.execute( AutoTune { 4000, 1 << 22, 1000 } );
+      test.execute( SetRTT { 100 } );
+      test.execute( OfferWindowScale { 7 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_window_scale( 0 ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 64000, 'x' ) ) );
+      test.execute( Pop { 64000 } );
+      test.execute( Tick { 100 } );
+      test.execute( ExpectCapacity { 128000 } );
+      test.execute( ExpectScaledWindow { 128000 } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -103,6 +103,16 @@ int main()
       test.execute( ExpectWindow { UINT16_MAX } );
     }
 
+    {
+      TCPReceiverTestHarness test { "MSS option on SYN", 4000 };
+      test.execute( ExpectPeerMSS { std::optional<uint16_t> {} } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( 5 ).with_mss( 1460 ) );
+      test.execute( ExpectAckno { Wrap32 { 6 } } );
+      test.execute( ExpectPeerMSS { 1460 } );
+      test.execute( SegmentArrives {}.with_seqno( 6 ).with_data( "abc" ).with_mss( 536 ) );
+      test.execute( ExpectPeerMSS { 1460 } );
+    }
+
     {
       TCPReceiverTestHarness test { "window size at max+5", UINT16_MAX + 5 };
       test.execute( ExpectWindow { UINT16_MAX } );
@@ -0,0 +1,132 @@
+#include "random.hh"
+#include "receiver_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "without delayed acks every segment is acked", 4000 };
+      test.execute( ExpectNoAck {} );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 1 } ) );
+      test.execute( ExpectNoAck {} );
+      test.execute( ExpectAcksPerByte { 100000, 1000, 100 } );
+      test.execute( ExpectAcksPerByte { 100000, 100, 1000 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "delayed acks halve the acks for full segments", 4000 };
+      test.execute( DelayAcks { 200, 1000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 1 } ) );
+      test.execute( ExpectAcksPerByte { 100000, 1000, 50 } );
+
+      // small segments are acked per two full segments' worth of bytes
+      test.execute( ExpectAcksPerByte { 100000, 100, 50 } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPConfig cfg;
+      cfg.recv_capacity = 4000;
+      cfg.mss = 500;
+      cfg.delayed_ack = true;
+      cfg.delayed_ack_timeout_ms = 40;
+
+      TCPReceiverTestHarness test { "delayed acks configured through TCPConfig", cfg };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 1 } ) );
+      test.execute( ExpectAcksPerByte { 100000, 500, 100 } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 100001 ).with_data( "abc" ) );
+      test.execute( Tick { 39 } );
+      test.execute( ExpectNoAck {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 100004 } ) );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "a lone segment is acked when the timer expires", 4000 };
+      test.execute( DelayAcks { 200, 1000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {} );
+      test.execute( Tick { 500 } );
+      test.execute( ExpectNoAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectNoAck {} );
+      test.execute( Tick { 199 } );
+      test.execute( ExpectNoAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 9 } ) );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectNoAck {} );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "out-of-order data and gap fills are acked at once", 4000 };
+      test.execute( DelayAcks { 200, 1000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 1 } ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 9 } ) );
+
+      // a duplicate is acked at once too, in case our previous ack was lost
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 9 } ) );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "FIN is acked at once; pure acks draw none", 4000 };
+      test.execute( DelayAcks { 200, 1000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ) );
+      test.execute( ExpectNoAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abc" ).with_fin() );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 5 } ) );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "a reopened window is advertised at once", 2000 };
+      test.execute( DelayAcks { 200, 1000 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectAck {}.with_window( 2000 ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 1000, 'x' ) ) );
+      test.execute( ExpectNoAck {} );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1001 ).with_data( string( 1000, 'x' ) ) );
+      test.execute( ExpectAck {}.with_ackno( Wrap32 { isn + 2001 } ).with_window( 0 ) );
+
+      // less than one MSS of room is not worth an update
+      test.execute( Pop { 500 } );
+      test.execute( ExpectNoAck {} );
+      test.execute( Pop { 500 } );
+      test.execute( ExpectAck {}.with_window( 1000 ) );
+      test.execute( Pop { 1000 } );
+      test.execute( ExpectNoAck {} );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include "random.hh"
+#include "receiver_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "no SACK blocks for in-order data", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectSack { {} } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 5 } } );
+      test.execute( ExpectSack { {} } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "each stored range is a block, newest first", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 13 ).with_data( "mnop" ) );
+      test.execute( ExpectSack { { { Wrap32 { isn + 13 }, Wrap32 { isn + 17 } } } } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 5 ).with_data( "efgh" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 1 } } );
+      test.execute( ExpectSack { { { Wrap32 { isn + 5 }, Wrap32 { isn + 9 } },
+                                   { Wrap32 { isn + 13 }, Wrap32 { isn + 17 } } } } );
+
+      // a duplicate within a block moves that block to the front
+      test.execute( SegmentArrives {}.with_seqno( isn + 13 ).with_data( "mn" ) );
+      test.execute( ExpectSack { { { Wrap32 { isn + 13 }, Wrap32 { isn + 17 } },
+                                   { Wrap32 { isn + 5 }, Wrap32 { isn + 9 } } } } );
+
+      // adjacent data extends a block
+      test.execute( SegmentArrives {}.with_seqno( isn + 9 ).with_data( "ij" ) );
+      test.execute( ExpectSack { { { Wrap32 { isn + 5 }, Wrap32 { isn + 11 } },
+                                   { Wrap32 { isn + 13 }, Wrap32 { isn + 17 } } } } );
+
+      // filling the first hole turns the first block into acked data
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( "abcd" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 11 } } );
+      test.execute( ExpectSack { { { Wrap32 { isn + 13 }, Wrap32 { isn + 17 } } } } );
+
+      test.execute( SegmentArrives {}.with_seqno( isn + 11 ).with_data( "kl" ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 17 } } );
+      test.execute( ExpectSack { {} } );
+      test.execute( ReadAll { "abcdefghijklmnop" } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "at most MAX_SACK_BLOCKS blocks are reported", 4000 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      for ( uint32_t i = 1; i <= 6; ++i ) {
+        test.execute( SegmentArrives {}.with_seqno( isn + 1 + 10 * i ).with_data( "xyz" ) );
+      }
+      test.execute( BytesPending { 18 } );
+
+      // the newest blocks are kept, so the oldest information is what gets dropped
+      test.execute( ExpectSack { { { Wrap32 { isn + 61 }, Wrap32 { isn + 64 } },
+                                   { Wrap32 { isn + 51 }, Wrap32 { isn + 54 } },
+                                   { Wrap32 { isn + 41 }, Wrap32 { isn + 44 } },
+                                   { Wrap32 { isn + 31 }, Wrap32 { isn + 34 } } } } );
+
+      // data landing in an older block moves it to the front
+      test.execute( SegmentArrives {}.with_seqno( isn + 14 ).with_data( "w" ) );
+      test.execute( ExpectSack { { { Wrap32 { isn + 11 }, Wrap32 { isn + 15 } },
+                                   { Wrap32 { isn + 61 }, Wrap32 { isn + 64 } },
+                                   { Wrap32 { isn + 51 }, Wrap32 { isn + 54 } },
+                                   { Wrap32 { isn + 41 }, Wrap32 { isn + 44 } } } } );
+    }
+
+    {
+      const uint32_t isn = uniform_int_distribution<uint32_t> { 0, UINT32_MAX }( rd );
+      TCPReceiverTestHarness test { "blocks after the stream has moved on", 100 };
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 50, 'a' ) ) );
+      test.execute( ReadAll { string( 50, 'a' ) } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 61 ).with_data( string( 10, 'c' ) ) );
+      test.execute( SegmentArrives {}.with_seqno( isn + 81 ).with_data( string( 10, 'e' ) ) );
+      test.execute( ExpectSack { { { Wrap32 { isn + 81 }, Wrap32 { isn + 91 } },
+                                   { Wrap32 { isn + 61 }, Wrap32 { isn + 71 } } } } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 51 ).with_data( string( 10, 'b' ) ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 71 } } );
+      test.execute( ExpectSack { { { Wrap32 { isn + 81 }, Wrap32 { isn + 91 } } } } );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
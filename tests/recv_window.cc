@@ -105,6 +105,29 @@ int main()
       test.execute( BytesPending( 0 ) );
     }
 
+    {
+      const uint32_t isn = 23452;
+      TCPReceiverTestHarness test { "window scaling advertises a 10 MB capacity", 10'000'000 };
+      test.execute( OfferWindowScale { 8 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ).with_window_scale( 2 ) );
+      test.execute( ExpectWindow { 39062 } );
+      test.execute( ExpectScaledWindow { 39062 << 8 } );
+      test.execute( SegmentArrives {}.with_seqno( isn + 1 ).with_data( string( 100'000, 'x' ) ) );
+      test.execute( ExpectAckno { Wrap32 { isn + 100'001 } } );
+      test.execute( ExpectWindow { 9'900'000 >> 8 } );
+      test.execute( ReadAll { string( 100'000, 'x' ) } );
+      test.execute( ExpectWindow { 39062 } );
+    }
+
+    {
+      const uint32_t isn = 23452;
+      TCPReceiverTestHarness test { "no window scaling unless the peer's SYN offers it", 10'000'000 };
+      test.execute( OfferWindowScale { 8 } );
+      test.execute( SegmentArrives {}.with_syn().with_seqno( isn ) );
+      test.execute( ExpectWindow { UINT16_MAX } );
+      test.execute( ExpectScaledWindow { UINT16_MAX } );
+    }
+
   } catch ( const exception& e ) {
     cerr << e.what() << endl;
     return 1;
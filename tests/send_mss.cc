@@ -0,0 +1,164 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+
+      TCPSenderTestHarness test { "SYN advertises the default MSS", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ).with_mss( TCPConfig::MAX_PAYLOAD_SIZE ) );
+      test.execute( ExpectMSS { TCPConfig::MAX_PAYLOAD_SIZE } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.mss = 1460;
+
+      TCPSenderTestHarness test { "An Ethernet-sized MSS fills the segments", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ).with_mss( 1460 ) );
+      test.execute( PeerMSS { 8960 } );
+      test.execute( ExpectMSS { 1460 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 4000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1461 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1080 ).with_seqno( isn + 2921 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.mss = 1460;
+
+      TCPSenderTestHarness test { "The peer's smaller MSS wins", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( PeerMSS { 536 } );
+      test.execute( ExpectMSS { 536 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 1200, 'x' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 536 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 536 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 128 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.mss = 8960;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "Jumbo frames, with the initial window sized for them", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ).with_mss( 8960 ) );
+      test.execute( ExpectCwnd { 2 * 8960 } );
+      test.execute( PeerMSS { 1460 } );
+      test.execute( ExpectCwnd { 3 * 1460 } );
+      test.execute( PeerMSS { 8960 } );
+      test.execute( ExpectCwnd { 2 * 8960 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 20000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 8960 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 8960 ).with_seqno( isn + 8961 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t retx_timeout = uniform_int_distribution<uint16_t> { 10, 1000 }( rd );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = retx_timeout;
+      cfg.mss = 1460;
+
+      TCPSenderTestHarness test { "Without pmtu_probing the MSS never shrinks", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 1460, 'x' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ) );
+      for ( unsigned i = 0; i < 4; ++i ) {
+        test.execute( Tick { static_cast<uint64_t>( retx_timeout ) << i } );
+        test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1 ) );
+      }
+      test.execute( ExpectMSS { 1460 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      const uint16_t retx_timeout = uniform_int_distribution<uint16_t> { 10, 1000 }( rd );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = retx_timeout;
+      cfg.mss = 1460;
+      cfg.pmtu_probing = true;
+      cfg.pmtu_probe_interval_ms = 100000;
+
+      TCPSenderTestHarness test { "Full-sized segments lost repeatedly shrink the MSS", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 10000 ) );
+      test.execute( Push { string( 3000, 'x' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1461 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 80 ).with_seqno( isn + 2921 ) );
+
+      test.execute( Tick { retx_timeout } );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectMSS { 1460 } );
+
+      // the second timeout halves the MSS, and the lost segment is resent in pieces
+      test.execute( Tick { 2 * static_cast<uint64_t>( retx_timeout ) } );
+      test.execute( ExpectMSS { 730 } );
+      test.execute( ExpectMessage {}.with_payload_size( 730 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectSeqnosInFlight { 3000 } );
+
+      test.execute( AckReceived { Wrap32 { isn + 731 } }.with_win( 10000 ) );
+      test.execute( Tick { retx_timeout } );
+      test.execute( ExpectMessage {}.with_payload_size( 730 ).with_seqno( isn + 731 ) );
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 10000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+
+      test.execute( Push { string( 1000, 'y' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 730 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 270 ).with_seqno( isn + 3731 ) );
+      test.execute( AckReceived { Wrap32 { isn + 4001 } }.with_win( 10000 ) );
+
+      // the full MSS is tried again after pmtu_probe_interval_ms
+      test.execute( Tick { 100000 } );
+      test.execute( ExpectMSS { 1460 } );
+      test.execute( Push { string( 2000, 'z' ) } );
+      test.execute( ExpectMessage {}.with_payload_size( 1460 ).with_seqno( isn + 4001 ) );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
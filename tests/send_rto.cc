@@ -0,0 +1,160 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = 1000;
+
+      TCPSenderTestHarness test { "Without adaptive_rto the RTO stays fixed", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 100 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } } );
+      test.execute( ExpectRTO { 1000 } );
+      test.execute( ExpectSRTT { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+
+      TCPSenderTestHarness test { "SRTT and RTO follow RTT samples", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( ExpectRTO { 1000 } );
+      test.execute( ExpectSRTT { 0 } );
+
+      // first sample: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 * RTTVAR
+      test.execute( Tick { 100 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } } );
+      test.execute( ExpectSRTT { 100 } );
+      test.execute( ExpectRTO { 300 } );
+
+      // RTTVAR = 3/4 * 50 + 1/4 * |100 - 60| = 47.5, SRTT = 7/8 * 100 + 1/8 * 60 = 95
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_data( "abc" ) );
+      test.execute( Tick { 60 } );
+      test.execute( AckReceived { Wrap32 { isn + 4 } } );
+      test.execute( ExpectSRTT { 95 } );
+      test.execute( ExpectRTO { 285 } );
+
+      // Karn: an ack covering a retransmitted segment gives no sample, and the backed-off RTO stays
+      test.execute( Push { "de" } );
+      test.execute( ExpectMessage {}.with_data( "de" ) );
+      test.execute( Tick { 284 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_data( "de" ) );
+      test.execute( ExpectRTO { 570 } );
+      test.execute( Tick { 50 } );
+      test.execute( AckReceived { Wrap32 { isn + 6 } } );
+      test.execute( ExpectSRTT { 95 } );
+      test.execute( ExpectRTO { 570 } );
+
+      // the next clean sample replaces the backed-off value: RTTVAR = 3/4 * 47.5, SRTT = 95
+      test.execute( Push { "f" } );
+      test.execute( ExpectMessage {}.with_data( "f" ) );
+      test.execute( Tick { 95 } );
+      test.execute( AckReceived { Wrap32 { isn + 7 } } );
+      test.execute( ExpectSRTT { 95 } );
+      test.execute( ExpectRTO { 238 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+
+      TCPSenderTestHarness test { "A LAN path's RTO is held at the lower bound", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 1 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } } );
+      test.execute( ExpectSRTT { 1 } );
+      test.execute( ExpectRTO { TCPConfig::RTO_MIN_DFLT } );
+
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_data( "abc" ) );
+      test.execute( Tick { TCPConfig::RTO_MIN_DFLT - 1 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( Tick { 1 } );
+      test.execute( ExpectMessage {}.with_data( "abc" ) );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+
+      TCPSenderTestHarness test { "A 400 ms path is not retransmitted spuriously", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 400 } );
+      test.execute( AckReceived { Wrap32 { isn + 1 } } );
+      test.execute( ExpectSRTT { 400 } );
+      test.execute( ExpectRTO { 1200 } );
+
+      test.execute( Push { "abc" } );
+      test.execute( ExpectMessage {}.with_data( "abc" ) );
+      test.execute( Tick { 400 } );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { Wrap32 { isn + 4 } } );
+      test.execute( ExpectSRTT { 400 } );
+      test.execute( ExpectRTO { 1000 } );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.rt_timeout = 1000;
+      cfg.adaptive_rto = true;
+      cfg.rto_max_ms = 4000;
+
+      TCPSenderTestHarness test { "Exponential back-off stops at the upper bound", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( Tick { 1000 } );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( ExpectRTO { 2000 } );
+      test.execute( Tick { 2000 } );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( ExpectRTO { 4000 } );
+      test.execute( Tick { 4000 } );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( ExpectRTO { 4000 } );
+      test.execute( Tick { 3999 } );
+      test.execute( ExpectNoSegment {} );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
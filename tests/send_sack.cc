@@ -0,0 +1,145 @@
+#include "random.hh"
+#include "sender_test_harness.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+  try {
+    auto rd = get_random_engine();
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+
+      TCPSenderTestHarness test { "Every hole below the highest SACK block is resent at once", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 8000 ) );
+      test.execute( Push { string( 8000, 'x' ) } );
+      for ( unsigned i = 0; i < 8; ++i ) {
+        test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+
+      // the segments at isn + 1001 and isn + 4001 are lost
+      const Wrap32 ackno { isn + 1001 };
+      test.execute( AckReceived { ackno }.with_win( 8000 ) );
+      test.execute( AckReceived { ackno }.with_win( 8000 ).with_sack( isn + 2001, isn + 3001 ) );
+      test.execute( AckReceived { ackno }.with_win( 8000 ).with_sack( isn + 2001, isn + 4001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { ackno }
+                      .with_win( 8000 )
+                      .with_sack( isn + 2001, isn + 4001 )
+                      .with_sack( isn + 5001, isn + 6001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 4001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( ExpectConsecutiveRetransmissions { 0 } );
+
+      // later blocks above the holes don't resend them again
+      test.execute( AckReceived { ackno }
+                      .with_win( 8000 )
+                      .with_sack( isn + 2001, isn + 4001 )
+                      .with_sack( isn + 5001, isn + 7001 ) );
+      test.execute( ExpectNoSegment {} );
+
+      test.execute( AckReceived { Wrap32 { isn + 4001 } }.with_win( 8000 ).with_sack( isn + 5001, isn + 7001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { Wrap32 { isn + 8001 } }.with_win( 8000 ) );
+      test.execute( ExpectSeqnosInFlight { 0 } );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+
+      TCPSenderTestHarness test { "A segment only partly covered by a block is still a hole", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 5000 ) );
+      test.execute( Push { string( 5000, 'x' ) } );
+      for ( unsigned i = 0; i < 5; ++i ) {
+        test.execute( ExpectMessage {}.with_payload_size( 1000 ) );
+      }
+      for ( unsigned i = 0; i < 3; ++i ) {
+        test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 5000 ).with_sack( isn + 1001, isn + 2501 ) );
+      }
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 1 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // the block grows to cover the segment at isn + 2001 after all; the one above it is still unknown
+      test.execute( AckReceived { Wrap32 { isn + 1 } }
+                      .with_win( 5000 )
+                      .with_sack( isn + 1001, isn + 3001 )
+                      .with_sack( isn + 4001, isn + 5001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+
+    {
+      TCPConfig cfg;
+      const Wrap32 isn( rd() );
+      cfg.fixed_isn = isn;
+      cfg.congestion_control = CongestionControlAlgorithm::NewReno;
+
+      TCPSenderTestHarness test { "NewReno's partial ack doesn't resend a hole SACK already resent", cfg };
+      test.execute( Push {} );
+      test.execute( ExpectMessage {}.with_syn( true ).with_seqno( isn ) );
+      test.execute( AckReceived { Wrap32 { isn + 1 } }.with_win( 60000 ) );
+      test.execute( Push { string( 20000, 'x' ) } );
+      for ( unsigned i = 0; i < 4; ++i ) {
+        test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 1 + 1000 * i ) );
+      }
+      test.execute( AckReceived { Wrap32 { isn + 1001 } }.with_win( 60000 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 4001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 5001 ) );
+
+      // the segments at isn + 1001 and isn + 3001 are lost
+      const Wrap32 ackno { isn + 1001 };
+      test.execute( AckReceived { ackno }.with_win( 60000 ).with_sack( isn + 2001, isn + 3001 ) );
+      test.execute( AckReceived { ackno }
+                      .with_win( 60000 )
+                      .with_sack( isn + 2001, isn + 3001 )
+                      .with_sack( isn + 4001, isn + 5001 ) );
+      test.execute( ExpectNoSegment {} );
+      test.execute( AckReceived { ackno }
+                      .with_win( 60000 )
+                      .with_sack( isn + 2001, isn + 3001 )
+                      .with_sack( isn + 4001, isn + 6001 ) );
+      test.execute( ExpectSsthresh { 2500 } );
+      test.execute( ExpectCwnd { 5500 } );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 1001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 3001 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 500 ).with_seqno( isn + 6001 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // the partial ack leaves isn + 3001 at the front, but it has been resent already
+      test.execute( AckReceived { Wrap32 { isn + 3001 } }.with_win( 60000 ).with_sack( isn + 4001, isn + 6001 ) );
+      test.execute( ExpectCwnd { 4500 } );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 6501 ) );
+      test.execute( ExpectNoSegment {} );
+
+      // the full ack ends recovery
+      test.execute( AckReceived { Wrap32 { isn + 7501 } }.with_win( 60000 ) );
+      test.execute( ExpectCwnd { 2000 } );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 7501 ) );
+      test.execute( ExpectMessage {}.with_payload_size( 1000 ).with_seqno( isn + 8501 ) );
+      test.execute( ExpectNoSegment {} );
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return 1;
+  }
+
+  return EXIT_SUCCESS;
+}
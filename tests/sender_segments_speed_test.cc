@@ -0,0 +1,146 @@
+#include "byte_stream.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+using namespace std::chrono;
+
+void speed_test( const string& mode,      // NOLINT(bugprone-easily-swappable-parameters)
+                 TCPConfig config,        // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t input_len,  // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t write_size, // NOLINT(bugprone-easily-swappable-parameters)
+                 const uint64_t rtt_ms )
+{
+  const string data = [&input_len] {
+    default_random_engine rd { 1729 };
+    uniform_int_distribution<char> ud;
+    string ret;
+    for ( size_t i = 0; i < input_len; ++i ) {
+      ret += ud( rd );
+    }
+    return ret;
+  }();
+
+  constexpr uint16_t window = 65535;
+  const Wrap32 isn { 1729 };
+  config.fixed_isn = isn;
+  TCPSender sender { config };
+  ByteStream outbound { 65536 };
+  string output_data;
+  output_data.reserve( data.size() );
+
+  // The application writes `write_size` bytes every millisecond. The synthetic receiver takes every segment
+  // in order and its ack reaches the sender `rtt_ms` later.
+  uint64_t now = 0;
+  uint64_t next_abs_seqno = 0;
+  bool fin_received = false;
+  deque<pair<uint64_t, uint64_t>> acks_in_flight; // (arrival time, absolute ackno)
+  size_t segments = 0;
+  size_t wire_segments = 0;
+
+  const auto start_time = steady_clock::now();
+
+  size_t written = 0;
+  while ( not fin_received ) {
+    now++;
+    sender.tick( 1 );
+    while ( not acks_in_flight.empty() and acks_in_flight.front().first <= now ) {
+      sender.receive( TCPReceiverMessage { isn + acks_in_flight.front().second, window } );
+      acks_in_flight.pop_front();
+    }
+
+    if ( written < data.size() ) {
+      const auto piece = string_view { data }.substr( written, write_size );
+      if ( piece.size() <= outbound.writer().available_capacity() ) {
+        outbound.writer().push( string { piece } );
+        written += piece.size();
+      }
+    } else if ( not outbound.writer().is_closed() ) {
+      outbound.writer().close();
+    }
+
+    sender.push( outbound.reader() );
+
+    bool sent_any = false;
+    while ( auto msg = sender.maybe_send() ) {
+      if ( msg->seqno != isn + next_abs_seqno ) {
+        throw runtime_error( "TCPSender sent a segment out of order" );
+      }
+      sent_any = true;
+      segments++;
+      wire_segments += split_super_segment( *msg, TCPConfig::MAX_PAYLOAD_SIZE ).size();
+      output_data += msg->payload;
+      next_abs_seqno += msg->sequence_length();
+      fin_received |= msg->FIN;
+    }
+    if ( sent_any ) {
+      acks_in_flight.emplace_back( now + rtt_ms, next_abs_seqno );
+    }
+  }
+
+  const auto stop_time = steady_clock::now();
+
+  if ( data != output_data ) {
+    throw runtime_error( "Mismatch between data written and received" );
+  }
+
+  auto test_duration = duration_cast<duration<double>>( stop_time - start_time );
+  auto bytes_per_second = static_cast<double>( input_len ) / test_duration.count();
+  auto gigabits_per_second = 8 * bytes_per_second / 1e9;
+  const double segments_per_byte = static_cast<double>( segments ) / static_cast<double>( input_len );
+  const double wire_segments_per_byte = static_cast<double>( wire_segments ) / static_cast<double>( input_len );
+
+  fstream debug_output;
+  debug_output.open( "/dev/tty" );
+
+  cout << "TCPSender (" << mode << ") with write_size=" << write_size << ", rtt=" << rtt_ms << " ms sent "
+       << segments << " segments (" << wire_segments << " on the wire) for " << input_len << " bytes: " << fixed
+       << setprecision( 5 ) << segments_per_byte << " segments/byte, " << wire_segments_per_byte
+       << " wire segments/byte, " << setprecision( 2 ) << gigabits_per_second << " Gbit/s.\n";
+
+  debug_output << "             TCPSender segments/byte (" << mode << ", write_size=" << write_size
+               << "): " << fixed << setprecision( 5 ) << segments_per_byte << " (wire " << wire_segments_per_byte
+               << ")\n";
+
+  if ( gigabits_per_second < 0.01 ) {
+    throw runtime_error( "TCPSender did not meet minimum speed of 0.01 Gbit/s." );
+  }
+}
+
+void program_body()
+{
+  TCPConfig nagle;
+  nagle.nagle = true;
+  TCPConfig super_segment;
+  super_segment.super_segment_size = 16000;
+  TCPConfig both = nagle;
+  both.super_segment_size = 16000;
+
+  speed_test( "default", {}, 1 << 20, 100, 10 );
+  speed_test( "nagle", nagle, 1 << 20, 100, 10 );
+  speed_test( "nagle + super-segment", both, 1 << 20, 100, 10 );
+  speed_test( "default", {}, 1 << 20, 16000, 10 );
+  speed_test( "super-segment", super_segment, 1 << 20, 16000, 10 );
+}
+
+int main()
+{
+  try {
+    program_body();
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include "byte_stream.hh"
+#include "tcp_sender.hh"
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+using namespace std::chrono;
+
+void speed_test( const size_t input_len,   // NOLINT(bugprone-easily-swappable-parameters)
+                 const uint16_t window,    // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t random_seed, // NOLINT(bugprone-easily-swappable-parameters)
+                 const size_t write_size,  // NOLINT(bugprone-easily-swappable-parameters)
+                 const bool ack_each_segment )
+{
+  // Generate the data to be written
+  const string data = [&random_seed, &input_len] {
+    default_random_engine rd { random_seed };
+    uniform_int_distribution<char> ud;
+    string ret;
+    for ( size_t i = 0; i < input_len; ++i ) {
+      ret += ud( rd );
+    }
+    return ret;
+  }();
+
+  const Wrap32 isn { static_cast<uint32_t>( random_seed ) };
+  TCPSender sender { 1000, isn };
+  ByteStream outbound { 65536 };
+  string output_data;
+  output_data.reserve( data.size() );
+
+  // The synthetic receiver accepts every segment in order and acknowledges it with a fixed window.
+  uint64_t next_abs_seqno = 0;
+  bool fin_received = false;
+  const auto ack = [&] { return TCPReceiverMessage { isn + next_abs_seqno, window }; };
+
+  const auto start_time = steady_clock::now();
+
+  size_t written = 0;
+  while ( not fin_received ) {
+    if ( written < data.size() ) {
+      const auto piece = string_view { data }.substr( written, write_size );
+      if ( piece.size() <= outbound.writer().available_capacity() ) {
+        outbound.writer().push( string { piece } );
+        written += piece.size();
+      }
+    } else if ( not outbound.writer().is_closed() ) {
+      outbound.writer().close();
+    }
+
+    sender.push( outbound.reader() );
+
+    bool sent_any = false;
+    while ( auto msg = sender.maybe_send() ) {
+      sent_any = true;
+      if ( msg->seqno != isn + next_abs_seqno ) {
+        throw runtime_error( "TCPSender sent a segment out of order" );
+      }
+      output_data += msg->payload;
+      next_abs_seqno += msg->sequence_length();
+      fin_received |= msg->FIN;
+      if ( ack_each_segment ) {
+        sender.receive( ack() );
+      }
+    }
+    if ( sent_any and not ack_each_segment ) {
+      sender.receive( ack() );
+    }
+  }
+
+  const auto stop_time = steady_clock::now();
+
+  if ( data != output_data ) {
+    throw runtime_error( "Mismatch between data written and received" );
+  }
+  if ( sender.sequence_numbers_in_flight() != 0 ) {
+    throw runtime_error( "TCPSender still has sequence numbers in flight after the final ack" );
+  }
+
+  auto test_duration = duration_cast<duration<double>>( stop_time - start_time );
+  auto bytes_per_second = static_cast<double>( input_len ) / test_duration.count();
+  auto bits_per_second = 8 * bytes_per_second;
+  auto gigabits_per_second = bits_per_second / 1e9;
+
+  fstream debug_output;
+  debug_output.open( "/dev/tty" );
+
+  const string ack_mode = ack_each_segment ? "per segment" : "per flight";
+
+  cout << "TCPSender with window=" << window << ", write_size=" << write_size << ", acks " << ack_mode
+       << " reached " << fixed << setprecision( 2 ) << gigabits_per_second << " Gbit/s.\n";
+
+  debug_output << "             TCPSender throughput (window=" << window << ", acks " << ack_mode
+               << "): " << fixed << setprecision( 2 ) << gigabits_per_second << " Gbit/s\n";
+
+  if ( gigabits_per_second < 0.1 ) {
+    throw runtime_error( "TCPSender did not meet minimum speed of 0.1 Gbit/s." );
+  }
+}
+
+void program_body()
+{
+  speed_test( 1 << 20, 65535, 789, 1500, true );
+  speed_test( 1 << 20, 65535, 789, 1500, false );
+  speed_test( 1 << 20, 8192, 789, 4096, false );
+}
+
+int main()
+{
+  try {
+    program_body();
+  } catch ( const exception& e ) {
+    cerr << "Exception: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
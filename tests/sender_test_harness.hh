@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hh"
+#include "congestion_control.hh"
 #include "tcp_config.hh"
 #include "tcp_receiver_message.hh"
 #include "tcp_sender.hh"
@@ -54,6 +55,56 @@ struct ExpectSeqnosInFlight : public ExpectNumber<StreamAndSender, uint64_t>
   uint64_t value( StreamAndSender& ss ) const override { return ss.second.sequence_numbers_in_flight(); }
 };
 
+static const CongestionControl& congestion_control_of( const TCPSender& sender )
+{
+  if ( sender.congestion_control() == nullptr ) {
+    throw std::runtime_error( "inconsistent test: TCPSender has no congestion control" );
+  }
+  return *sender.congestion_control();
+}
+
+struct ExpectCwnd : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "congestion_control().cwnd"; }
+  uint64_t value( StreamAndSender& ss ) const override { return congestion_control_of( ss.second ).cwnd(); }
+};
+
+struct ExpectSsthresh : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "congestion_control().ssthresh"; }
+  uint64_t value( StreamAndSender& ss ) const override { return congestion_control_of( ss.second ).ssthresh(); }
+};
+
+struct ExpectConsecutiveRetransmissions : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "consecutive_retransmissions"; }
+  uint64_t value( StreamAndSender& ss ) const override { return ss.second.consecutive_retransmissions(); }
+};
+
+struct ExpectMSS : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "mss"; }
+  uint64_t value( StreamAndSender& ss ) const override { return ss.second.mss(); }
+};
+
+struct ExpectRTO : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "current_RTO_ms"; }
+  uint64_t value( StreamAndSender& ss ) const override { return ss.second.current_RTO_ms(); }
+};
+
+struct ExpectSRTT : public ExpectNumber<StreamAndSender, uint64_t>
+{
+  using ExpectNumber::ExpectNumber;
+  std::string name() const override { return "srtt_ms (0 before the first sample)"; }
+  uint64_t value( StreamAndSender& ss ) const override { return ss.second.srtt_ms().value_or( 0 ); }
+};
+
 struct ExpectNoSegment : public Expectation<StreamAndSender>
 {
   std::string description() const override { return "nothing to send"; }
@@ -150,11 +201,15 @@ struct Receive : public Action<StreamAndSender>
   TCPReceiverMessage msg_;
   bool push_ = true;
 
-  explicit Receive( TCPReceiverMessage msg ) : msg_( msg ) {}
+  explicit Receive( TCPReceiverMessage msg ) : msg_( std::move( msg ) ) {}
   std::string description() const override
   {
     std::ostringstream desc;
-    desc << "receive(ack=" << to_string( msg_.ackno ) << ", win=" << msg_.window_size << ")";
+    desc << "receive(ack=" << to_string( msg_.ackno ) << ", win=" << msg_.window_size;
+    for ( const auto& block : msg_.sack ) {
+      desc << ", sack=" << to_string( block.begin ) << "-" << to_string( block.end );
+    }
+    desc << ")";
     if ( push_ ) {
       desc << ", then push stream to TCPSender";
     }
@@ -167,6 +222,12 @@ struct Receive : public Action<StreamAndSender>
     return *this;
   }
 
+  Receive& with_sack( Wrap32 begin, Wrap32 end )
+  {
+    msg_.sack.push_back( { begin, end } );
+    return *this;
+  }
+
   void execute( StreamAndSender& ss ) const override
   {
     ss.second.receive( msg_ );
@@ -187,6 +248,27 @@ struct AckReceived : public Receive
   explicit AckReceived( Wrap32 ackno ) : Receive( { ackno, DEFAULT_TEST_WINDOW } ) {}
 };
 
+struct PeerMSS : public Action<StreamAndSender>
+{
+  uint16_t mss_;
+
+  explicit PeerMSS( uint16_t mss ) : mss_( mss ) {}
+  std::string description() const override { return "peer's SYN carries MSS option " + std::to_string( mss_ ); }
+  void execute( StreamAndSender& ss ) const override { ss.second.set_peer_mss( mss_ ); }
+};
+
+struct PeerWindowScale : public Action<StreamAndSender>
+{
+  uint8_t shift_;
+
+  explicit PeerWindowScale( uint8_t shift ) : shift_( shift ) {}
+  std::string description() const override
+  {
+    return "peer's SYN carries window scale option " + std::to_string( shift_ );
+  }
+  void execute( StreamAndSender& ss ) const override { ss.second.set_peer_window_scale( shift_ ); }
+};
+
 struct Close : public Push
 {
   Close() : Push( "" ) { with_close(); }
@@ -199,6 +281,8 @@ struct ExpectMessage : public Expectation<StreamAndSender>
   std::optional<Wrap32> seqno {};
   std::optional<std::string> data {};
   std::optional<size_t> payload_size {};
+  std::optional<uint16_t> mss {};
+  std::optional<uint8_t> window_scale {};
 
   ExpectMessage& with_syn( bool syn_ )
   {
@@ -212,6 +296,18 @@ struct ExpectMessage : public Expectation<StreamAndSender>
     return *this;
   }
 
+  ExpectMessage& with_mss( uint16_t mss_ )
+  {
+    mss = mss_;
+    return *this;
+  }
+
+  ExpectMessage& with_window_scale( uint8_t shift )
+  {
+    window_scale = shift;
+    return *this;
+  }
+
   ExpectMessage& with_no_flags()
   {
     syn = false;
@@ -261,6 +357,12 @@ struct ExpectMessage : public Expectation<StreamAndSender>
     if ( fin.has_value() ) {
       o << ( fin.value() ? " +FIN" : " (no FIN)" );
     }
+    if ( mss.has_value() ) {
+      o << " mss=" << mss.value();
+    }
+    if ( window_scale.has_value() ) {
+      o << " window_scale=" << static_cast<unsigned>( window_scale.value() );
+    }
     return o.str();
   }
 
@@ -290,7 +392,15 @@ struct ExpectMessage : public Expectation<StreamAndSender>
     if ( payload_size.has_value() and seg.payload.size() != payload_size.value() ) {
       throw ExpectationViolation( "payload_size", payload_size.value(), seg.payload.size() );
     }
-    if ( seg.payload.size() > TCPConfig::MAX_PAYLOAD_SIZE ) {
+    if ( mss.has_value() and seg.mss != mss ) {
+      throw ExpectationViolation( "MSS option", mss, seg.mss );
+    }
+    if ( window_scale.has_value() and seg.window_scale != window_scale ) {
+      throw ExpectationViolation( "window scale option",
+                                  std::optional<unsigned> { window_scale },
+                                  std::optional<unsigned> { seg.window_scale } );
+    }
+    if ( seg.payload.size() > ss.second.mss() ) {
       throw ExpectationViolation( "payload has length (" + std::to_string( seg.payload.size() )
                                   + ") greater than the maximum" );
     }
@@ -301,12 +411,63 @@ struct ExpectMessage : public Expectation<StreamAndSender>
   }
 };
 
+struct ExpectSuperSegment : public Expectation<StreamAndSender>
+{
+  Wrap32 seqno_;
+  size_t payload_size_;
+  size_t pieces_;
+
+  ExpectSuperSegment( Wrap32 seqno, size_t payload_size, size_t pieces )
+    : seqno_( seqno ), payload_size_( payload_size ), pieces_( pieces )
+  {}
+
+  std::string description() const override
+  {
+    return "super-segment sent with seqno=" + to_string( seqno_ )
+           + " payload_len=" + std::to_string( payload_size_ ) + ", split into " + std::to_string( pieces_ )
+           + " pieces";
+  }
+
+  void execute( StreamAndSender& ss ) const override
+  {
+    const auto maybe_seg = ss.second.maybe_send();
+    if ( not maybe_seg.has_value() ) {
+      throw ExpectationViolation( "expected a message, but none was sent" );
+    }
+    const TCPSenderMessage& seg = maybe_seg.value();
+    if ( seg.seqno != seqno_ ) {
+      throw ExpectationViolation( "sequence number", seqno_, seg.seqno );
+    }
+    if ( seg.payload.size() != payload_size_ ) {
+      throw ExpectationViolation( "payload_size", payload_size_, seg.payload.size() );
+    }
+
+    const auto pieces = split_super_segment( seg, ss.second.mss() );
+    if ( pieces.size() != pieces_ ) {
+      throw ExpectationViolation( "number of pieces", pieces_, pieces.size() );
+    }
+    Wrap32 next_seqno = seg.seqno;
+    std::string joined;
+    for ( const auto& piece : pieces ) {
+      if ( piece.seqno != next_seqno or piece.payload.size() > ss.second.mss() ) {
+        throw ExpectationViolation( "super-segment was split into a bad piece: " + to_string( piece ) );
+      }
+      next_seqno = next_seqno + piece.sequence_length();
+      joined += std::string_view( piece.payload );
+    }
+    if ( joined != std::string_view( seg.payload ) ) {
+      throw ExpectationViolation( "the pieces of the super-segment don't add up to its payload" );
+    }
+  }
+};
+
 class TCPSenderTestHarness : public TestHarness<StreamAndSender>
 {
 public:
   TCPSenderTestHarness( std::string name, TCPConfig config )
     : TestHarness( move( name ),
                    "initial_RTO_ms=" + to_string( config.rt_timeout ),
-                   { ByteStream { config.send_capacity }, TCPSender { config.rt_timeout, config.fixed_isn } } )
+                   { ByteStream { config.send_capacity },
+                     TCPSender { config } } )
   {}
 };
@@ -0,0 +1,158 @@
+#include "byte_stream.hh"
+#include "reassembler.hh"
+#include "tcp_config.hh"
+#include "tcp_receiver.hh"
+#include "tcp_sender.hh"
+#include "trace.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// This test is built against a library compiled with MINNOW_TRACE_SENDER and MINNOW_TRACE_RECEIVER.
+
+namespace {
+
+string dump()
+{
+  ostringstream out;
+  TraceRing::global().dump( out );
+  return out.str();
+}
+
+vector<string> lines( const string& text )
+{
+  vector<string> ret;
+  istringstream in { text };
+  for ( string line; getline( in, line ); ) {
+    ret.push_back( line );
+  }
+  return ret;
+}
+
+void expect_line( const string& text, const string& line )
+{
+  if ( ( "\n" + text ).find( "\n" + line + "\n" ) == string::npos ) {
+    throw runtime_error( "trace should have had the line \"" + line + "\", but it was:\n" + text );
+  }
+}
+
+void expect_prefix( const string& text, const string& prefix )
+{
+  if ( ( "\n" + text ).find( "\n" + prefix ) == string::npos ) {
+    throw runtime_error( "trace should have had a line starting \"" + prefix + "\", but it was:\n" + text );
+  }
+}
+
+// Run a short connection: SYN, five bytes, and the acks coming back.
+void traffic()
+{
+  const TCPConfig cfg;
+  TCPSender sender { cfg };
+  ByteStream outbound { cfg.send_capacity };
+  ByteStream inbound { cfg.recv_capacity };
+  Reassembler reassembler;
+  TCPReceiver receiver;
+
+  const auto exchange = [&] {
+    sender.push( outbound.reader() );
+    while ( auto msg = sender.maybe_send() ) {
+      receiver.receive( move( *msg ), reassembler, inbound.writer() );
+      sender.receive( receiver.send( inbound.writer() ) );
+    }
+  };
+
+  exchange();
+  outbound.writer().push( "hello" );
+  exchange();
+}
+
+} // namespace
+
+int main()
+{
+  try {
+    dump(); // start from an empty trace
+
+    {
+      traffic();
+      const string trace = dump();
+      expect_prefix( trace, "[sender] push bytes,segments,window " );
+      expect_prefix( trace, "[sender] maybe_send seqno,len,queued " );
+      expect_prefix( trace, "[sender] receive ackno,window " );
+      expect_line( trace, "[receiver] receive abs_seqno,stream_index,assembled 0 0 0" );
+      expect_line( trace, "[receiver] receive abs_seqno,stream_index,assembled 1 0 5" );
+      expect_prefix( trace, "[receiver] send bytes_pushed,window 5 " );
+
+      if ( not dump().empty() ) {
+        throw runtime_error( "a second dump() should print nothing new" );
+      }
+    }
+
+    {
+      // only the newest ring's worth of records survives
+      for ( uint64_t i = 0; i < TraceRing::capacity + 10; ++i ) {
+        TraceRing::global().record( TraceModule::Sender, "event", i, i, i );
+      }
+      const auto dumped = lines( dump() );
+      if ( dumped.size() != TraceRing::capacity ) {
+        throw runtime_error( "dump() should print " + to_string( TraceRing::capacity ) + " records, not "
+                             + to_string( dumped.size() ) );
+      }
+      if ( dumped.front() != "[sender] event 10 10 10" ) {
+        throw runtime_error( "the oldest surviving record should be #10, not \"" + dumped.front() + "\"" );
+      }
+    }
+
+    {
+      // records dumped while writers overwrite them are never torn
+      atomic<bool> done { false };
+      vector<thread> writers;
+      for ( uint64_t w = 0; w < 2; ++w ) {
+        writers.emplace_back( [&done, w] {
+          for ( uint64_t i = 0; not done.load( memory_order_relaxed ); ++i ) {
+            const uint64_t v = i * 2 + w;
+            TraceRing::global().record( TraceModule::Receiver, "concurrent", v, v, v );
+          }
+        } );
+      }
+
+      for ( unsigned round = 0; round < 200; ++round ) {
+        for ( const auto& line : lines( dump() ) ) {
+          istringstream in { line };
+          string module;
+          string event;
+          uint64_t a = 0;
+          uint64_t b = 0;
+          uint64_t c = 0;
+          in >> module >> event >> a >> b >> c;
+          if ( module != "[receiver]" or event != "concurrent" or a != b or b != c ) {
+            done = true;
+            for ( auto& t : writers ) {
+              t.join();
+            }
+            throw runtime_error( "dump() printed a torn record: \"" + line + "\"" );
+          }
+        }
+      }
+      done = true;
+      for ( auto& t : writers ) {
+        t.join();
+      }
+    }
+  } catch ( const exception& e ) {
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -17,6 +17,7 @@ public:
   // NOLINTEND(*-explicit-*)
 
   std::string&& release() { return std::move( *buffer_ ); }
+  bool unique() const { return buffer_.use_count() == 1; } // Is this the only reference to the string?
   size_t size() const { return buffer_->size(); }
   size_t length() const { return buffer_->length(); }
   bool empty() const { return buffer_->empty(); }
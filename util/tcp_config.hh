@@ -6,17 +6,73 @@
 #include <cstdint>
 #include <optional>
 
+//! Congestion-control policy run by the TCP sender (see src/congestion_control.hh)
+enum class CongestionControlAlgorithm
+{
+  None,    //!< Limited only by the receiver's window
+  Reno,    //!< RFC 5681
+  NewReno, //!< RFC 6582
+  Cubic,   //!< RFC 9438
+};
+
 //! Config for TCP sender and receiver
 class TCPConfig
 {
 public:
-  static constexpr size_t DEFAULT_CAPACITY = 64000; //!< Default capacity
-  static constexpr size_t MAX_PAYLOAD_SIZE = 1000;  //!< Conservative max payload size for real Internet
-  static constexpr uint16_t TIMEOUT_DFLT = 1000;    //!< Default re-transmit timeout is 1 second
-  static constexpr unsigned MAX_RETX_ATTEMPTS = 8;  //!< Maximum re-transmit attempts before giving up
+  static constexpr size_t DEFAULT_CAPACITY = 64000;   //!< Default capacity
+  static constexpr size_t MAX_PAYLOAD_SIZE = 1000;    //!< Conservative max payload size for real Internet
+  static constexpr uint16_t TIMEOUT_DFLT = 1000;      //!< Default re-transmit timeout is 1 second
+  static constexpr unsigned MAX_RETX_ATTEMPTS = 8;    //!< Maximum re-transmit attempts before giving up
+  static constexpr uint64_t RTO_MIN_DFLT = 200;       //!< Lower bound on an adaptive RTO, in milliseconds
+  static constexpr uint64_t RTO_MAX_DFLT = 60000;     //!< Upper bound on an adaptive RTO, in milliseconds
+  static constexpr uint64_t NAGLE_TIMEOUT_DFLT = 200; //!< Longest a sub-MSS tail is held back, in milliseconds
+  static constexpr uint8_t MAX_WINDOW_SHIFT = 14;     //!< Largest window-scale shift (RFC 7323)
+  static constexpr uint64_t ACK_DELAY_DFLT = 200;     //!< Longest an ack is delayed, in milliseconds (RFC 1122)
+
+  // Path-MTU probing: the MSS is halved, down to MIN_MSS, once PMTU_LOSS_THRESHOLD consecutive timeouts
+  // hit a full-sized segment, and the full MSS is tried again PMTU_PROBE_INTERVAL_DFLT milliseconds later.
+  static constexpr uint16_t MIN_MSS = 536;
+  static constexpr unsigned PMTU_LOSS_THRESHOLD = 2;
+  static constexpr uint64_t PMTU_PROBE_INTERVAL_DFLT = 600000;
+
+  // Receive-buffer auto-tuning keeps the receive capacity between these bounds by default.
+  static constexpr size_t RECV_CAPACITY_MIN_DFLT = 4096;
+  static constexpr size_t RECV_CAPACITY_MAX_DFLT = 1 << 22;
 
   uint16_t rt_timeout = TIMEOUT_DFLT;      //!< Initial value of the retransmission timeout, in milliseconds
   size_t recv_capacity = DEFAULT_CAPACITY; //!< Receive capacity, in bytes
   size_t send_capacity = DEFAULT_CAPACITY; //!< Sender capacity, in bytes
   std::optional<Wrap32> fixed_isn {};
+  uint16_t mss = MAX_PAYLOAD_SIZE; //!< Largest payload this end sends or accepts; advertised on SYN
+  CongestionControlAlgorithm congestion_control = CongestionControlAlgorithm::None; //!< Sender's congestion control
+  bool cubic_fast_convergence = true; //!< With CUBIC, lower W_max further when losses come early
+  bool adaptive_rto = false;          //!< Derive the RTO from measured RTTs (RFC 6298) instead of rt_timeout
+  uint64_t rto_min_ms = RTO_MIN_DFLT; //!< With adaptive_rto, the smallest RTO
+  uint64_t rto_max_ms = RTO_MAX_DFLT; //!< With adaptive_rto, the largest RTO, including back-off
+  bool nagle = false;                 //!< Hold back a sub-MSS tail while earlier data is unacknowledged (RFC 896)
+  uint64_t nagle_timeout_ms = NAGLE_TIMEOUT_DFLT; //!< With nagle, send the held tail anyway after this long
+  size_t super_segment_size = 0; //!< If nonzero, payload limit of the segments push() emits, to be split into
+                                 //!< MSS-sized pieces by a lower layer (see split_super_segment)
+  bool pmtu_probing = false; //!< Halve the MSS when full-sized segments keep timing out (RFC 4821 black holes)
+  uint64_t pmtu_probe_interval_ms = PMTU_PROBE_INTERVAL_DFLT; //!< With pmtu_probing, then retry the full MSS
+  bool window_scaling = false; //!< Offer RFC 7323 window scaling on SYN, so windows can exceed 64 KB
+  bool delayed_ack = false;    //!< Receiver acks every second full segment instead of every segment
+  uint64_t delayed_ack_timeout_ms = ACK_DELAY_DFLT; //!< With delayed_ack, ack a lone segment after this long
+  bool recv_autotuning = false; //!< Grow recv_capacity with the application's drain rate (see WindowTuner)
+  size_t recv_capacity_min = RECV_CAPACITY_MIN_DFLT; //!< With recv_autotuning, the smallest receive capacity
+  size_t recv_capacity_max = RECV_CAPACITY_MAX_DFLT; //!< With recv_autotuning, the largest receive capacity
+  uint64_t recv_idle_ms = TIMEOUT_DFLT; //!< With recv_autotuning, shrink to the minimum after this long idle
+
+  //! The window-scale shift this end offers: the smallest that fits the largest receive capacity (which
+  //! auto-tuning may raise to recv_capacity_max) in the 16-bit window field
+  uint8_t window_shift() const
+  {
+    const size_t largest
+      = recv_autotuning and recv_capacity_max > recv_capacity ? recv_capacity_max : recv_capacity;
+    uint8_t shift = 0;
+    while ( shift < MAX_WINDOW_SHIFT and ( largest >> shift ) > UINT16_MAX ) {
+      ++shift;
+    }
+    return shift;
+  }
 };
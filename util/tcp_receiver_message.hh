@@ -2,23 +2,43 @@
 
 #include "wrapping_integers.hh"
 
+#include <cstddef>
 #include <optional>
+#include <vector>
 
 /*
  * The TCPReceiverMessage structure contains the information sent from a TCP receiver to its sender.
  *
- * It contains two fields:
+ * It contains three fields:
  *
  * 1) The acknowledgment number (ackno): the *next* sequence number needed by the TCP Receiver.
  *    This is an optional field that is empty if the TCPReceiver hasn't yet received the Initial Sequence Number.
  *
  * 2) The window size. This is the number of sequence numbers that the TCP receiver is interested
  *    to receive, starting from the ackno if present. The maximum value is 65,535 (UINT16_MAX from
- *    the <cstdint> header).
+ *    the <cstdint> header). If window scaling was negotiated on SYN, the window is this value shifted
+ *    left by the receiver's window-scale shift.
+ *
+ * 3) Selective acknowledgment (SACK) blocks, as in RFC 2018. Each block is a range [begin, end) of
+ *    sequence numbers beyond the ackno that the TCP receiver already holds, so the sender only needs
+ *    to retransmit the holes between them. There are at most MAX_SACK_BLOCKS. The first block holds
+ *    the most recently received segment, followed by the blocks reported before (RFC 2018 section 4);
+ *    the list is empty when nothing has arrived out of order.
  */
 
+struct SackBlock
+{
+  Wrap32 begin { 0 };
+  Wrap32 end { 0 };
+
+  bool operator==( const SackBlock& other ) const = default;
+};
+
 struct TCPReceiverMessage
 {
+  static constexpr size_t MAX_SACK_BLOCKS = 4;
+
   std::optional<Wrap32> ackno {};
   uint16_t window_size {};
+  std::vector<SackBlock> sack {};
 };
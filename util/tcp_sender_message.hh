@@ -3,12 +3,14 @@
 #include "buffer.hh"
 #include "wrapping_integers.hh"
 
+#include <cstdint>
+#include <optional>
 #include <string>
 
 /*
  * The TCPSenderMessage structure contains the information sent from a TCP sender to its receiver.
  *
- * It contains four fields:
+ * It contains six fields:
  *
  * 1) The sequence number (seqno) of the beginning of the segment. If the SYN flag is set, this is the
  *    sequence number of the SYN flag. Otherwise, it's the sequence number of the beginning of the payload.
@@ -19,6 +21,12 @@
  * 3) The payload: a substring (possibly empty) of the byte stream.
  *
  * 4) The FIN flag. If set, it means the payload represents the ending of the byte stream.
+ *
+ * 5) The maximum segment size (MSS) option, sent only with the SYN: the largest payload the sender's
+ *    own receiver is willing to accept in one segment. It is empty if the option isn't present.
+ *
+ * 6) The window scale option (RFC 7323), sent only with the SYN: the shift the sender's own receiver
+ *    applies to the windows it advertises. Scaling is in effect only if both SYNs carry the option.
  */
 
 struct TCPSenderMessage
@@ -27,6 +35,8 @@ struct TCPSenderMessage
   bool SYN { false };
   Buffer payload {};
   bool FIN { false };
+  std::optional<uint16_t> mss {};
+  std::optional<uint8_t> window_scale {};
 
   // How many sequence numbers does this segment use?
   size_t sequence_length() const { return SYN + payload.size() + FIN; }
@@ -0,0 +1,55 @@
+#include "trace.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+TraceRing& TraceRing::global()
+{
+  static TraceRing ring;
+  return ring;
+}
+
+void TraceRing::record( TraceModule module, const char* event, uint64_t a, uint64_t b, uint64_t c )
+{
+  const uint64_t position = next_.fetch_add( 1, memory_order_relaxed );
+  TraceRecord& rec = records_[position % capacity];
+
+  // Mark the slot as being written, fill it in, then publish it under its position.
+  rec.ticket.store( 0, memory_order_relaxed );
+  atomic_thread_fence( memory_order_release );
+  rec.module.store( module, memory_order_relaxed );
+  rec.event.store( event, memory_order_relaxed );
+  rec.args[0].store( a, memory_order_relaxed );
+  rec.args[1].store( b, memory_order_relaxed );
+  rec.args[2].store( c, memory_order_relaxed );
+  rec.ticket.store( position + 1, memory_order_release );
+}
+
+void TraceRing::dump( ostream& out )
+{
+  const uint64_t end = next_.load( memory_order_acquire );
+  // Records older than one ring's worth have been overwritten.
+  uint64_t position = max( dumped_, end > capacity ? end - capacity : 0 );
+
+  for ( ; position < end; ++position ) {
+    const TraceRecord& rec = records_[position % capacity];
+    if ( rec.ticket.load( memory_order_acquire ) != position + 1 ) {
+      continue; // still being written, or already overwritten
+    }
+    const TraceModule module = rec.module.load( memory_order_relaxed );
+    const char* event = rec.event.load( memory_order_relaxed );
+    const array<uint64_t, 3> args { rec.args[0].load( memory_order_relaxed ),
+                                    rec.args[1].load( memory_order_relaxed ),
+                                    rec.args[2].load( memory_order_relaxed ) };
+    atomic_thread_fence( memory_order_acquire );
+    if ( rec.ticket.load( memory_order_relaxed ) != position + 1 ) {
+      continue; // overwritten while we were copying it
+    }
+
+    out << ( module == TraceModule::Sender ? "[sender] " : "[receiver] " ) << event << " " << args[0] << " "
+        << args[1] << " " << args[2] << "\n";
+  }
+
+  dumped_ = end;
+}
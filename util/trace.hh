@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*
+ * A zero-cost event trace for the TCP hot paths.
+ *
+ * MINNOW_TRACE( module, event, a, b, c ) records an event name and up to three numbers
+ * into an in-memory ring. Each module compiles to nothing unless it was enabled at
+ * configure time, e.g. `cmake -DMINNOW_TRACE="sender;receiver"`, which defines
+ * MINNOW_TRACE_SENDER and MINNOW_TRACE_RECEIVER. Recording never takes a lock or makes a
+ * system call; call TraceRing::global().dump() later to print what was captured.
+ */
+
+enum class TraceModule : uint8_t
+{
+  Sender,
+  Receiver,
+};
+
+constexpr bool trace_enabled( TraceModule module )
+{
+  switch ( module ) {
+    case TraceModule::Sender:
+#ifdef MINNOW_TRACE_SENDER
+      return true;
+#else
+      return false;
+#endif
+    case TraceModule::Receiver:
+#ifdef MINNOW_TRACE_RECEIVER
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+// The payload fields are atomics (accessed relaxed) so that dump() may read a slot while a writer refills it;
+// the ticket tells dump() whether what it read was one complete record.
+struct TraceRecord
+{
+  std::atomic<uint64_t> ticket {}; // 1 + position in the trace once the record is complete, 0 while writing
+  std::atomic<TraceModule> module {};
+  std::atomic<const char*> event {}; // a string literal naming the event and its arguments
+  std::array<std::atomic<uint64_t>, 3> args {};
+};
+
+class TraceRing
+{
+public:
+  static constexpr size_t capacity = 4096; // records kept before the oldest are overwritten
+
+  static TraceRing& global();
+
+  // Append a record. Safe to call from several threads at once.
+  void record( TraceModule module, const char* event, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0 );
+
+  // Print (and forget) every complete record written since the last dump, oldest first.
+  void dump( std::ostream& out );
+
+private:
+  std::array<TraceRecord, capacity> records_ {};
+  std::atomic<uint64_t> next_ { 0 }; // position of the next record to write
+  uint64_t dumped_ { 0 };            // position of the next record to dump
+};
+
+#define MINNOW_TRACE( module, ... )                                                                                \
+  do {                                                                                                             \
+    if constexpr ( trace_enabled( TraceModule::module ) ) {                                                        \
+      TraceRing::global().record( TraceModule::module, __VA_ARGS__ );                                             \
+    }                                                                                                              \
+  } while ( false )